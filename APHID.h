@@ -0,0 +1,271 @@
+//
+// APHID (asynchronous parallel hierarchical iterative deepening): a master owns the top plies of the tree and the
+// positions at its frontier are handed to worker threads, which deepen them one iteration at a time on their own.
+// Nobody waits for anybody: workers always take the shallowest leaf the master still needs, and the master keeps
+// re-running alpha-beta over its small tree from whatever depth each leaf has reached so far.
+// Every pass hands each leaf it visits the window it was visited with, so a leaf search is an alpha-beta search with
+// the master's bounds rather than a full window one. Leaves the pass cut off are not needed and nobody deepens them
+// until a later pass visits them again. A leaf whose last result is a bound that no longer settles its window is
+// uncertain and searched again at the same depth.
+//
+
+#ifndef APHID_H
+#define APHID_H
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <omp.h>
+
+#include "Engine.h"
+
+template<int maxDepth>
+class APHID {
+    private:
+        struct Leaf {
+            StockDory::Board board;
+            int ply;
+            //claimed by the thread currently deepening it
+            std::atomic<bool> busy{false};
+            //visited by the last pass of the master
+            std::atomic<bool> needed{false};
+            //deepest search whose result settles the current window
+            std::atomic<int> depth{0};
+            std::mutex lock;
+            //window of the last pass that visited it, from the leaf's side
+            int alpha = -50000;
+            int beta = 50000;
+            //last search and what its score is
+            int searchedDepth = 0;
+            Bound bound = ExactBound;
+            std::array<Move, maxDepth> line;
+            int score;
+        };
+
+        struct Node {
+            Move move;
+            std::vector<int> children;
+            int leaf = -1;
+            //position without moves inside the master tree, score of the mate or stalemate
+            int score = 0;
+            //value of the last pass, orders the children of the next one
+            int value = 0;
+        };
+
+        Engine engine;
+        //shared by every thread, a leaf deepened one more ply finds its earlier iterations here
+        NumaTranspositionTable<SearchEntry> transpositionTable{16 * 1024 * 1024};
+        std::deque<Leaf> leaves;
+        std::vector<Node> nodes;
+        //leaf searches finished so far, the master re-evaluates whenever it moves
+        std::atomic<int> completed{0};
+        std::atomic<bool> finished{false};
+        //shallowest settled result the current pass used, a worker finishing a leaf after the pass read it does not count
+        int passDepth = 0;
+
+        template<Color color>
+        void expand(StockDory::Board &chessBoard, int node, int ply, int masterDepth) {
+            const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
+            if (ply == masterDepth or moveList.Count() == 0) {
+                if (moveList.Count() == 0) {
+                    nodes[node].score = engine.alphaBetaNega<color, maxDepth>(chessBoard, -50000, 50000, 0, ply).second;
+                    return;
+                }
+                //depth 0 value so the master has an answer before any worker reports
+                Leaf &leaf = leaves.emplace_back();
+                leaf.board = chessBoard;
+                leaf.ply = ply;
+                leaf.score = engine.alphaBetaNega<color, maxDepth>(chessBoard, -50000, 50000, 0, ply).second;
+                nodes[node].leaf = leaves.size() - 1;
+                return;
+            }
+            constexpr enum Color Ocolor = Opposite(color);
+            for (uint8_t i = 0; i < moveList.Count(); i++) {
+                Move nextMove = moveList[i];
+                int child = nodes.size();
+                nodes.emplace_back();
+                nodes[child].move = nextMove;
+                nodes[node].children.push_back(child);
+                PreviousState prevState = chessBoard.Move<ZOBRIST>(nextMove.From(), nextMove.To(), nextMove.Promotion());
+                expand<Ocolor>(chessBoard, child, ply + 1, masterDepth);
+                chessBoard.UndoMove<ZOBRIST>(prevState, nextMove.From(), nextMove.To());
+            }
+        }
+
+        //whether the last result of the leaf answers its window, the caller holds the lock
+        static bool settled(const Leaf &leaf) {
+            return leaf.bound == ExactBound or
+                   (leaf.bound == LowerBound and leaf.score >= leaf.beta) or
+                   (leaf.bound == UpperBound and leaf.score <= leaf.alpha);
+        }
+
+        //alpha-beta over the master tree with the latest leaf results, best child of the last pass first
+        std::pair<std::array<Move, maxDepth>, int> evaluate(int node, int alpha, int beta) {
+            if (nodes[node].leaf >= 0) {
+                Leaf &leaf = leaves[nodes[node].leaf];
+                std::lock_guard<std::mutex> guard(leaf.lock);
+                leaf.alpha = alpha;
+                leaf.beta = beta;
+                //a bound that no longer settles the window -> search the same depth again
+                int depth = settled(leaf) ? leaf.searchedDepth : leaf.searchedDepth - 1;
+                leaf.depth.store(depth, std::memory_order_relaxed);
+                leaf.needed.store(true, std::memory_order_release);
+                passDepth = std::min(passDepth, depth);
+                nodes[node].value = leaf.score;
+                return std::make_pair(leaf.line, leaf.score);
+            }
+            if (nodes[node].children.empty()) {
+                return std::make_pair(std::array<Move, maxDepth>(), nodes[node].score);
+            }
+            std::vector<int> &children = nodes[node].children;
+            std::stable_sort(children.begin(), children.end(), [this](int a, int b) {
+                return nodes[a].value < nodes[b].value;
+            });
+            std::array<Move, maxDepth> bestLine;
+            int bestScore = -50000;
+            for (int child : children) {
+                std::pair<std::array<Move, maxDepth>, int> result = evaluate(child, -beta, -alpha);
+                result.second = -result.second;
+                if (result.second > bestScore) {
+                    bestScore = result.second;
+                    bestLine[0] = nodes[child].move;
+                    for (int j = 0; j < maxDepth - 1; j++) {
+                        bestLine[j + 1] = result.first[j];
+                    }
+                }
+                alpha = std::max(alpha, result.second);
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+            nodes[node].value = bestScore;
+            return std::make_pair(bestLine, bestScore);
+        }
+
+        //one pass of the master -> only the leaves it visits are needed afterwards
+        std::pair<std::array<Move, maxDepth>, int> pass() {
+            for (Leaf &leaf : leaves) {
+                leaf.needed.store(false, std::memory_order_relaxed);
+            }
+            passDepth = maxDepth;
+            return evaluate(0, -50000, 50000);
+        }
+
+        //the shallowest needed leaf nobody is working on, -1 when there is none
+        int claim(int leafDepth) {
+            while (true) {
+                int best = -1;
+                for (size_t i = 0; i < leaves.size(); i++) {
+                    int depth = leaves[i].depth.load(std::memory_order_relaxed);
+                    if (depth < leafDepth and leaves[i].needed.load(std::memory_order_acquire) and
+                        not leaves[i].busy.load(std::memory_order_relaxed) and
+                        (best < 0 or depth < leaves[best].depth.load(std::memory_order_relaxed))) {
+                        best = i;
+                    }
+                }
+                if (best < 0 or not leaves[best].busy.exchange(true, std::memory_order_acquire)) {
+                    return best;
+                }
+            }
+        }
+
+        template<Color color>
+        void deepen(Leaf &leaf) {
+            int depth;
+            int alpha;
+            int beta;
+            {
+                std::lock_guard<std::mutex> guard(leaf.lock);
+                depth = leaf.depth.load(std::memory_order_relaxed) + 1;
+                //a second search of the same depth gets the full window, its score then settles any window
+                bool again = depth == leaf.searchedDepth;
+                alpha = again ? -50000 : leaf.alpha;
+                beta = again ? 50000 : leaf.beta;
+            }
+            StockDory::Board board = leaf.board;
+            std::pair<std::array<Move, maxDepth>, int> result =
+                    engine.alphaBetaNegaTT<color, maxDepth>(transpositionTable, board, alpha, beta, depth, leaf.ply);
+            engine.extendLineTT<color, maxDepth>(transpositionTable, board, result.first, 0, depth);
+            {
+                std::lock_guard<std::mutex> guard(leaf.lock);
+                leaf.line = result.first;
+                leaf.score = result.second;
+                leaf.bound = result.second <= alpha ? UpperBound : (result.second >= beta ? LowerBound : ExactBound);
+                leaf.searchedDepth = depth;
+                //the master may have moved the window while this search ran
+                leaf.depth.store(settled(leaf) ? depth : depth - 1, std::memory_order_relaxed);
+            }
+            leaf.busy.store(false, std::memory_order_release);
+            completed.fetch_add(1, std::memory_order_release);
+        }
+
+    public:
+        //report(depth, result) is called by the master every time all needed leaves have been searched one iteration deeper
+        template<typename Report>
+        std::pair<std::array<Move, maxDepth>, int> search(const StockDory::Board &chessBoard, int depth, int masterDepth, Report report) {
+            masterDepth = std::max(0, std::min(masterDepth, depth - 1));
+            int leafDepth = depth - masterDepth;
+            leaves.clear();
+            nodes.assign(1, Node());
+            completed.store(0);
+            finished.store(false);
+            StockDory::Board root = chessBoard;
+            if (root.ColorToMove() == White) {
+                expand<White>(root, 0, 0, masterDepth);
+            }
+            else {
+                expand<Black>(root, 0, 0, masterDepth);
+            }
+            //the first pass gives the leaves their windows before anyone claims one
+            std::pair<std::array<Move, maxDepth>, int> result = pass();
+            if (passDepth >= leafDepth) {
+                return result;
+            }
+
+            #pragma omp parallel
+            {
+                //thread 0 is the master, between two passes it deepens leaves like everybody else
+                bool master = omp_get_thread_num() == 0;
+                int seen = 0;
+                int reported = 0;
+                while (not finished.load(std::memory_order_acquire)) {
+                    if (master and completed.load(std::memory_order_acquire) != seen) {
+                        seen = completed.load(std::memory_order_acquire);
+                        result = pass();
+                        int done = passDepth;
+                        if (done > reported) {
+                            reported = done;
+                            report(masterDepth + done, result);
+                        }
+                        //every leaf the pass needed settles its window at full depth -> the pass is the answer
+                        if (done >= leafDepth) {
+                            finished.store(true, std::memory_order_release);
+                            break;
+                        }
+                    }
+                    int next = claim(leafDepth);
+                    if (next < 0) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    if (leaves[next].board.ColorToMove() == White) {
+                        deepen<White>(leaves[next]);
+                    }
+                    else {
+                        deepen<Black>(leaves[next]);
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        std::pair<std::array<Move, maxDepth>, int> search(const StockDory::Board &chessBoard, int depth, int masterDepth = 2) {
+            return search(chessBoard, depth, masterDepth, [](int, const std::pair<std::array<Move, maxDepth>, int> &) {});
+        }
+};
+
+#endif //APHID_H
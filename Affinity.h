@@ -0,0 +1,167 @@
+//
+// Thread placement. The cpus are read from /sys/devices/system/cpu and ordered one per physical core first, over all
+// packages, and the hyperthread siblings after that, so a sweep over the thread count only starts sharing cores once
+// every core has a thread. Cores of one NUMA node come together, so a small team stays on the node it starts on and
+// a bigger one fills the nodes one after the other. Where the topology cannot be read the cpus keep their numbering,
+// all of them count as node 0 and pinning does nothing.
+//
+
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <omp.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "Sysfs.h"
+
+class Affinity {
+    public:
+        struct Cpu {
+            int id;
+            //NUMA node, 0 on machines without any
+            int node;
+            int package;
+            int core;
+            //0 for the first hardware thread of its core, 1 for the second, ...
+            int sibling;
+        };
+
+    private:
+        static inline std::atomic<bool> pinning{false};
+
+        static std::vector<Cpu> read() {
+            const std::string root = "/sys/devices/system/cpu/";
+            std::vector<int> online = Sysfs::readList(root + "online");
+#if defined(__linux__)
+            //a container or taskset may allow fewer cpus than are online
+            cpu_set_t allowed;
+            if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+                std::erase_if(online, [&allowed](int id) { return id >= CPU_SETSIZE or not CPU_ISSET(id, &allowed); });
+            }
+#endif
+            if (online.empty()) {
+                int count = std::max(1, omp_get_num_procs());
+                for (int id = 0; id < count; id++) {
+                    online.push_back(id);
+                }
+            }
+            //cpu -> node, from the cpulist of every node
+            std::vector<int> nodeOf;
+            for (int node : Sysfs::readList("/sys/devices/system/node/online")) {
+                for (int id : Sysfs::readList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist")) {
+                    if (id >= (int) nodeOf.size()) {
+                        nodeOf.resize(id + 1, 0);
+                    }
+                    nodeOf[id] = node;
+                }
+            }
+            std::vector<Cpu> cpus;
+            for (int id : online) {
+                std::string topology = root + "cpu" + std::to_string(id) + "/topology/";
+                Cpu cpu = {id, id < (int) nodeOf.size() ? nodeOf[id] : 0, 0, id, 0};
+                try {
+                    cpu.package = std::stoi(Sysfs::readLine(topology + "physical_package_id"));
+                    cpu.core = std::stoi(Sysfs::readLine(topology + "core_id"));
+                }
+                catch (const std::exception &) {
+                }
+                std::vector<int> siblings = Sysfs::readList(topology + "thread_siblings_list");
+                std::sort(siblings.begin(), siblings.end());
+                cpu.sibling = std::find(siblings.begin(), siblings.end(), id) - siblings.begin();
+                if (cpu.sibling == (int) siblings.size()) {
+                    cpu.sibling = 0;
+                }
+                cpus.push_back(cpu);
+            }
+            std::stable_sort(cpus.begin(), cpus.end(), [](const Cpu &a, const Cpu &b) {
+                return std::tie(a.sibling, a.node, a.package, a.core, a.id) < std::tie(b.sibling, b.node, b.package, b.core, b.id);
+            });
+            return cpus;
+        }
+
+    public:
+        //the order threads are placed in, thread i goes on layout()[i % size]
+        static const std::vector<Cpu> &layout() {
+            static const std::vector<Cpu> cpus = read();
+            return cpus;
+        }
+
+        //whether search threads pin themselves as they start, set once before the searches run
+        static void enable(bool on) {
+            pinning.store(on);
+        }
+
+        static bool enabled() {
+            return pinning.load(std::memory_order_relaxed);
+        }
+
+        //pins the calling thread to the cpu of its slot, false where that is not possible
+        static bool pinCurrentThread(int slot) {
+#if defined(__linux__)
+            const Cpu &cpu = layout()[slot % layout().size()];
+            if (cpu.id >= CPU_SETSIZE) {
+                return false;
+            }
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu.id, &set);
+            return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+            return false;
+#endif
+        }
+
+        //pins each thread of a team of this size, the OpenMP runtime keeps the same threads for later regions of that size
+        static bool pinOpenMPThreads(int threads) {
+            bool pinned = true;
+            #pragma omp parallel num_threads(threads) reduction(&&:pinned)
+            {
+                pinned = pinCurrentThread(omp_get_thread_num());
+            }
+            return pinned;
+        }
+
+        //NUMA nodes the allowed cpus are spread over
+        static int nodeCount() {
+            std::set<int> nodes;
+            for (const Cpu &cpu : layout()) {
+                nodes.insert(cpu.node);
+            }
+            return nodes.size();
+        }
+
+        //"cpus 0 2 4 6 1 3, 4 on their own core, 2 on SMT siblings, 1 of 2 nodes", enough to reproduce a run
+        static std::string describe(int threads) {
+            const std::vector<Cpu> &cpus = layout();
+            std::string text = "cpus";
+            int own = 0;
+            std::set<std::pair<int, int>> cores;
+            std::set<int> nodes;
+            for (int slot = 0; slot < threads; slot++) {
+                const Cpu &cpu = cpus[slot % cpus.size()];
+                text += " " + std::to_string(cpu.id);
+                if (cores.insert({cpu.package, cpu.core}).second) {
+                    own++;
+                }
+                nodes.insert(cpu.node);
+            }
+            text += ", " + std::to_string(own) + " on their own core, " + std::to_string(threads - own) + " on SMT siblings";
+            //more threads than cpus -> the rest share a cpu rather than sit on a sibling
+            if (threads > (int) cpus.size()) {
+                text += " or shared cpus";
+            }
+            text += ", " + std::to_string(nodes.size()) + " of " + std::to_string(nodeCount()) + " nodes";
+            return text;
+        }
+};
+
+#endif //AFFINITY_H
@@ -18,6 +18,7 @@
 #include "Type/CheckBitBoard.h"
 #include "Type/PreviousState.h"
 #include "Type/Zobrist.h"
+#include "Type/Move.h"
 
 #include "Template/MoveType.h"
 
@@ -537,6 +538,74 @@ namespace StockDory
                 return attackers;
             }
 
+            // Cheap test for a move that did not come from this position's generator, such as a hash move: the side to
+            // move has a piece on the from square that can reach the to square. Pins and checks are not looked at.
+            [[nodiscard]]
+            constexpr inline bool IsPseudoLegal(const ::Move move) const
+            {
+                const Square from = move.From();
+                const Square to   = move.To  ();
+                const Color  us   = ColorToMove();
+
+                if (from == to || PieceAndColor[from].Color() != us || Get(ColorBB[us], to)) return false;
+
+                const Piece    piece     = PieceAndColor[from].Piece();
+                const Piece    promotion = move.Promotion();
+                const BitBoard occupied  = ~ColorBB[NAC];
+                const BitBoard target    = FromSquare(to);
+
+                const bool lastRank = us == White ? to >= A8 : to <= H1;
+                if (promotion != NAP && (piece != Pawn || !lastRank || promotion == Pawn || promotion == King))
+                    return false;
+
+                switch (piece) {
+                    case Pawn: {
+                        if (lastRank && promotion == NAP) return false;
+
+                        if (AttackTable::Pawn[us][from] & target)
+                            return target & (ColorBB[Opposite(us)] | EnPassantTarget);
+
+                        const int forward = us == White ? 8 : -8;
+                        if (to == from + forward) return !Get(occupied, to);
+
+                        const bool startRank = us == White ? from >= A2 && from <= H2 : from >= A7 && from <= H7;
+                        return startRank && to == from + 2 * forward &&
+                               !Get(occupied, static_cast<Square>(from + forward)) && !Get(occupied, to);
+                    }
+                    case Knight:
+                        return AttackTable::Knight[from] & target;
+                    case Bishop:
+                        return AttackTable::Sliding[BlackMagicFactory::MagicIndex(Bishop, from, occupied)] & target;
+                    case Rook:
+                        return AttackTable::Sliding[BlackMagicFactory::MagicIndex(Rook  , from, occupied)] & target;
+                    case Queen:
+                        return (AttackTable::Sliding[BlackMagicFactory::MagicIndex(Bishop, from, occupied)] |
+                                AttackTable::Sliding[BlackMagicFactory::MagicIndex(Rook  , from, occupied)]) & target;
+                    case King: {
+                        if (AttackTable::King[from] & target) return true;
+
+                        // Castling: right and empty path here, the attacked squares are left to the legality check.
+                        const Square home = us == White ? E1 : E8;
+                        if (from != home) return false;
+
+                        if (to == home + 2)
+                            return (us == White ? CastlingRightK<White>() : CastlingRightK<Black>()) &&
+                                   !(occupied & (FromSquare(static_cast<Square>(home + 1)) |
+                                                 FromSquare(static_cast<Square>(home + 2))));
+
+                        if (to == home - 2)
+                            return (us == White ? CastlingRightQ<White>() : CastlingRightQ<Black>()) &&
+                                   !(occupied & (FromSquare(static_cast<Square>(home - 1)) |
+                                                 FromSquare(static_cast<Square>(home - 2)) |
+                                                 FromSquare(static_cast<Square>(home - 3))));
+
+                        return false;
+                    }
+                    default:
+                        return false;
+                }
+            }
+
             constexpr inline PreviousStateNull Move()
             {
                 auto state = PreviousStateNull(EnPassantSquare());
@@ -0,0 +1,71 @@
+//
+// Batch analysis: position-level parallelism over a list of FENs.
+// Each position is searched by one thread (or a small group of threads), and positions are handed out dynamically,
+// so throughput scales with cores instead of with the efficiency of a single parallel search.
+//
+
+#ifndef BATCHANALYSIS_H
+#define BATCHANALYSIS_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <omp.h>
+
+#include "Engine.h"
+
+template<int maxDepth>
+class BatchAnalysis {
+    public:
+        struct Result {
+            size_t index;
+            std::string fen;
+            std::array<Move, maxDepth> bestLine;
+            int score;
+            double seconds;
+        };
+
+        //report is called for every position as soon as it is finished, one call at a time, in completion order
+        template<typename Report>
+        void analyze(const std::vector<std::string> &fens, int depth, int threadsPerPosition, Report report) {
+            threadsPerPosition = std::max(1, threadsPerPosition);
+            int groups = std::max(1, omp_get_max_threads() / threadsPerPosition);
+            //one engine and table per group -> the table stays warm across all the positions that group searches
+            std::vector<Engine> engines(groups);
+            std::vector<std::unique_ptr<NumaTranspositionTable<SearchEntry>>> tables;
+            for (int g = 0; g < groups; g++) {
+                tables.push_back(std::make_unique<NumaTranspositionTable<SearchEntry>>(16 * 1024 * 1024));
+            }
+            //nested teams for the groups, the setting is the caller's again however the batch ends
+            struct LevelsGuard {
+                int previous = omp_get_max_active_levels();
+                ~LevelsGuard() {
+                    omp_set_max_active_levels(previous);
+                }
+            } levelsGuard;
+            omp_set_max_active_levels(threadsPerPosition > 1 ? 2 : 1);
+
+            #pragma omp parallel for schedule(dynamic) num_threads(groups)
+            for (size_t i = 0; i < fens.size(); i++) {
+                Engine &engine = engines[omp_get_thread_num()];
+                NumaTranspositionTable<SearchEntry> &transpositionTable = *tables[omp_get_thread_num()];
+                //size of the nested team a parallel search on this thread will get
+                omp_set_num_threads(threadsPerPosition);
+                StockDory::Board chessBoard(fens[i]);
+                double tstart = omp_get_wtime();
+                //the same search whatever the group size: with one thread it is a full window search per iteration,
+                //with more the group's threads try speculative windows on the group's table
+                std::pair<std::array<Move, maxDepth>, int> result = chessBoard.ColorToMove() == White ?
+                        engine.iterativeParallelAspiration<White, maxDepth>(transpositionTable, chessBoard, depth) :
+                        engine.iterativeParallelAspiration<Black, maxDepth>(transpositionTable, chessBoard, depth);
+                Result finished = {i, fens[i], result.first, result.second, omp_get_wtime() - tstart};
+                #pragma omp critical
+                {
+                    report(finished);
+                }
+            }
+        }
+};
+
+#endif //BATCHANALYSIS_H
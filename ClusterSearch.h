@@ -0,0 +1,642 @@
+//
+// Distributed search over sockets: a coordinator splits the root moves across worker processes.
+// Workers listen on a Unix socket path ("/tmp/worker.sock") or a TCP address ("127.0.0.1:9000").
+// Messages are fixed-size binary headers, a request carries FEN + window + depth and a reply carries score + line.
+// Every field is written on its own, big-endian and without padding, so both ends agree whatever their compiler and CPU.
+// Transposition-driven scheduling (Romein et al.): every worker holds one shard of the global table, the positions whose
+// fastrange64(Zobrist, shards) is its index. A position at least routeDepth from the leaves is sent to the worker that
+// owns it, which answers from its shard or searches it and routes the children the same way, so a table lookup never
+// crosses the network. Below routeDepth a worker searches the subtree itself.
+//
+
+#ifndef CLUSTERSEARCH_H
+#define CLUSTERSEARCH_H
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "Engine.h"
+
+inline void PutBigEndian(uint8_t* out, const uint32_t value, const int bytes)
+{
+    for (int i = 0; i < bytes; i++) out[i] = static_cast<uint8_t>(value >> (8 * (bytes - 1 - i)));
+}
+
+inline uint32_t GetBigEndian(const uint8_t* in, const int bytes)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < bytes; i++) value = value << 8 | in[i];
+    return value;
+}
+
+struct SearchRequest
+{
+
+    public:
+        static constexpr size_t Size = 14;
+
+        int32_t  Alpha;
+        int32_t  Beta;
+        int16_t  Depth;
+        int16_t  Ply;
+        uint16_t FenLength;  // followed by FenLength bytes of FEN
+
+        void Encode(uint8_t* out) const
+        {
+            PutBigEndian(out     , static_cast<uint32_t>(Alpha)   , 4);
+            PutBigEndian(out +  4, static_cast<uint32_t>(Beta)    , 4);
+            PutBigEndian(out +  8, static_cast<uint16_t>(Depth)   , 2);
+            PutBigEndian(out + 10, static_cast<uint16_t>(Ply)     , 2);
+            PutBigEndian(out + 12, FenLength                      , 2);
+        }
+
+        static SearchRequest Decode(const uint8_t* in)
+        {
+            return {
+                static_cast<int32_t >(GetBigEndian(in     , 4)),
+                static_cast<int32_t >(GetBigEndian(in +  4, 4)),
+                static_cast<int16_t >(GetBigEndian(in +  8, 2)),
+                static_cast<int16_t >(GetBigEndian(in + 10, 2)),
+                static_cast<uint16_t>(GetBigEndian(in + 12, 2))
+            };
+        }
+
+};
+
+struct SearchReply
+{
+
+    public:
+        static constexpr size_t Size = 5;
+
+        int32_t Score;
+        uint8_t LineLength;  // followed by LineLength packed moves of 2 bytes each
+
+        void Encode(uint8_t* out) const
+        {
+            PutBigEndian(out    , static_cast<uint32_t>(Score), 4);
+            PutBigEndian(out + 4, LineLength                  , 1);
+        }
+
+        static SearchReply Decode(const uint8_t* in)
+        {
+            return {
+                static_cast<int32_t>(GetBigEndian(in    , 4)),
+                static_cast<uint8_t>(GetBigEndian(in + 4, 1))
+            };
+        }
+
+};
+
+template<int maxDepth>
+class ClusterSearch {
+    private:
+        Engine engine;
+        //only a process that searches itself needs one, a coordinator with working workers never does.
+        //In transposition-driven mode it is this worker's shard of the global table.
+        std::unique_ptr<NumaTranspositionTable<SearchEntry>> transpositionTable;
+        std::vector<int> workers;
+        //every worker in shard order, empty unless transposition-driven
+        std::vector<std::string> shards;
+        int routeDepth = 4;
+        //a worker searches one subtree at a time, however many positions it is answering
+        std::mutex searching;
+
+        static bool writeAll(int fd, const void *buffer, size_t size) {
+            const char *data = static_cast<const char *>(buffer);
+            while (size > 0) {
+                ssize_t written = write(fd, data, size);
+                if (written <= 0) {
+                    return false;
+                }
+                data += written;
+                size -= written;
+            }
+            return true;
+        }
+
+        static bool readAll(int fd, void *buffer, size_t size) {
+            char *data = static_cast<char *>(buffer);
+            while (size > 0) {
+                ssize_t received = read(fd, data, size);
+                if (received <= 0) {
+                    return false;
+                }
+                data += received;
+                size -= received;
+            }
+            return true;
+        }
+
+        static uint16_t packMove(Move move) {
+            return move.From() | (move.To() << 6) | (move.Promotion() << 12);
+        }
+
+        static Move unpackMove(uint16_t packed) {
+            return Move(static_cast<Square>(packed & 0x3F), static_cast<Square>((packed >> 6) & 0x3F), static_cast<Piece>(packed >> 12));
+        }
+
+        //unix socket paths start with '/', anything else is host:port
+        static int openSocket(const std::string &address, bool listening) {
+            if (address.front() == '/') {
+                sockaddr_un unixAddress = {};
+                unixAddress.sun_family = AF_UNIX;
+                if (address.size() >= sizeof(unixAddress.sun_path)) {
+                    return -1;
+                }
+                std::strcpy(unixAddress.sun_path, address.c_str());
+                int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+                if (fd < 0) {
+                    return -1;
+                }
+                if (listening) {
+                    unlink(address.c_str());
+                }
+                int status = listening ?
+                        bind(fd, reinterpret_cast<sockaddr *>(&unixAddress), sizeof(unixAddress)) :
+                        connect(fd, reinterpret_cast<sockaddr *>(&unixAddress), sizeof(unixAddress));
+                if (status != 0 or (listening and listen(fd, SOMAXCONN) != 0)) {
+                    close(fd);
+                    return -1;
+                }
+                return fd;
+            }
+
+            size_t colon = address.rfind(':');
+            if (colon == std::string::npos) {
+                return -1;
+            }
+            addrinfo hints = {};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            hints.ai_flags = listening ? AI_PASSIVE : 0;
+            addrinfo *found = nullptr;
+            if (getaddrinfo(address.substr(0, colon).c_str(), address.substr(colon + 1).c_str(), &hints, &found) != 0) {
+                return -1;
+            }
+            int fd = -1;
+            for (addrinfo *candidate = found; candidate != nullptr; candidate = candidate->ai_next) {
+                fd = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+                if (fd < 0) {
+                    continue;
+                }
+                int reuse = 1;
+                setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+                int status = listening ? bind(fd, candidate->ai_addr, candidate->ai_addrlen) : connect(fd, candidate->ai_addr, candidate->ai_addrlen);
+                if (status == 0 and (not listening or listen(fd, SOMAXCONN) == 0)) {
+                    break;
+                }
+                close(fd);
+                fd = -1;
+            }
+            freeaddrinfo(found);
+            return fd;
+        }
+
+        template<Color color>
+        std::pair<std::array<Move, maxDepth>, int> searchLocally(const StockDory::Board &board, int alpha, int beta, int depth, int ply) {
+            std::lock_guard<std::mutex> guard(searching);
+            if (not transpositionTable) {
+                transpositionTable = std::make_unique<NumaTranspositionTable<SearchEntry>>(16 * 1024 * 1024);
+            }
+            StockDory::Board localBoard = board;
+            return engine.alphaBetaNegaTT<color, maxDepth>(*transpositionTable, localBoard, alpha, beta, depth, ply);
+        }
+
+        //runs one request on this process, used by workers and as the fallback when a worker drops out
+        std::pair<std::array<Move, maxDepth>, int> searchLocally(const StockDory::Board &board, int alpha, int beta, int depth, int ply) {
+            if (board.ColorToMove() == White) {
+                return searchLocally<White>(board, alpha, beta, depth, ply);
+            }
+            return searchLocally<Black>(board, alpha, beta, depth, ply);
+        }
+
+        //sends the position to the worker owning its shard, the reply is read from the returned socket, -1 on failure
+        int sendToOwner(const StockDory::Board &board, int alpha, int beta, int depth, int ply) {
+            int fd = openSocket(shards[fastrange64(board.Zobrist(), shards.size())], false);
+            if (fd >= 0 and not sendRequest(fd, board, alpha, beta, depth, ply)) {
+                close(fd);
+                fd = -1;
+            }
+            return fd;
+        }
+
+        //a child above the cutoff is searched by its owner, below it or when the owner cannot be reached here
+        template<Color color>
+        std::pair<std::array<Move, maxDepth>, int> searchChild(const StockDory::Board &board, int alpha, int beta, int depth, int ply) {
+            int fd = depth >= routeDepth ? sendToOwner(board, alpha, beta, depth, ply) : -1;
+            if (fd >= 0) {
+                std::pair<std::array<Move, maxDepth>, int> result;
+                bool received = receiveReply(fd, result);
+                close(fd);
+                if (received) {
+                    return result;
+                }
+            }
+            return searchLocally<color>(board, alpha, beta, depth, ply);
+        }
+
+        //a position this worker owns -> answered from the shard if it can be, otherwise the eldest child is searched
+        //first for a bound and the others go out to their owners, one per shard at a time
+        template<Color color>
+        std::pair<std::array<Move, maxDepth>, int> routedSearch(const StockDory::Board &board, int alpha, int beta, int depth, int ply) {
+            if (depth < routeDepth) {
+                return searchLocally<color>(board, alpha, beta, depth, ply);
+            }
+            const ZobristHash hash = board.Zobrist();
+            //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+            if (ply > 0) {
+                alpha = std::max(alpha, -engine.mateScore + ply);
+                beta = std::min(beta, engine.mateScore - ply - 1);
+                if (alpha >= beta) {
+                    return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                }
+            }
+            const int alphaStart = alpha;
+            std::array<Move, maxDepth> bestLine;
+            SearchHit hit;
+            const bool found = (*transpositionTable)[hash].Probe(hash, hit);
+            if (found and ply > 0 and hit.Depth >= depth) {
+                int score = engine.scoreFromTT(hit.Score, ply);
+                if (hit.Type == ExactBound or (hit.Type == LowerBound and score >= beta) or (hit.Type == UpperBound and score <= alpha)) {
+                    bestLine[0] = hit.BestMove;
+                    return std::make_pair(bestLine, score);
+                }
+            }
+            const StockDory::SimplifiedMoveList<color> moveList(board);
+            //check for mate
+            if (moveList.Count() == 0 and board.Checked<color>()) {
+                return std::make_pair(std::array<Move, maxDepth>(), -engine.mateScore + ply);
+            }
+            //stalemate
+            else if (moveList.Count() == 0) {
+                return std::make_pair(std::array<Move, maxDepth>(), 0);
+            }
+            //the stored move goes first
+            std::vector<Move> moves;
+            for (uint8_t i = 0; i < moveList.Count(); i++) {
+                moves.push_back(moveList[i]);
+            }
+            if (found) {
+                std::vector<Move>::iterator stored = std::find(moves.begin(), moves.end(), hit.BestMove);
+                if (stored != moves.end()) {
+                    std::rotate(moves.begin(), stored, stored + 1);
+                }
+            }
+
+            constexpr enum Color Ocolor = Opposite(color);
+            int bestScore = -50000;
+            Move bestMove;
+            auto childBoard = [&](Move move) {
+                StockDory::Board child = board;
+                child.Move<ZOBRIST>(move.From(), move.To(), move.Promotion());
+                return child;
+            };
+            auto update = [&](Move move, std::pair<std::array<Move, maxDepth>, int> &result) {
+                result.second = -result.second;
+                if (result.second > bestScore) {
+                    bestScore = result.second;
+                    bestMove = move;
+                    bestLine[0] = move;
+                    for (int j = 0; j < depth - 1; j++) {
+                        bestLine[j + 1] = result.first[j];
+                    }
+                    alpha = std::max(alpha, bestScore);
+                }
+            };
+
+            std::pair<std::array<Move, maxDepth>, int> eldest = searchChild<Ocolor>(childBoard(moves[0]), -beta, -alpha, depth - 1, ply + 1);
+            update(moves[0], eldest);
+            size_t next = 1;
+            //sockets of the children their owners are searching right now
+            std::vector<std::pair<int, Move>> inFlight;
+            while (alpha < beta and (next < moves.size() or not inFlight.empty())) {
+                while (alpha < beta and next < moves.size() and inFlight.size() < shards.size()) {
+                    Move move = moves[next++];
+                    StockDory::Board child = childBoard(move);
+                    int fd = depth - 1 >= routeDepth ? sendToOwner(child, -beta, -alpha, depth - 1, ply + 1) : -1;
+                    if (fd >= 0) {
+                        inFlight.emplace_back(fd, move);
+                        continue;
+                    }
+                    std::pair<std::array<Move, maxDepth>, int> result = searchLocally<Ocolor>(child, -beta, -alpha, depth - 1, ply + 1);
+                    update(move, result);
+                }
+                if (inFlight.empty()) {
+                    continue;
+                }
+                std::vector<pollfd> waiting;
+                for (const std::pair<int, Move> &child : inFlight) {
+                    waiting.push_back({child.first, POLLIN, 0});
+                }
+                if (poll(waiting.data(), waiting.size(), -1) < 0) {
+                    continue;
+                }
+                for (size_t k = waiting.size(); k-- > 0;) {
+                    if (waiting[k].revents == 0) {
+                        continue;
+                    }
+                    auto [fd, move] = inFlight[k];
+                    std::pair<std::array<Move, maxDepth>, int> result;
+                    //a reply that never arrives is searched here
+                    if (not receiveReply(fd, result)) {
+                        result = searchLocally<Ocolor>(childBoard(move), -beta, -alpha, depth - 1, ply + 1);
+                    }
+                    close(fd);
+                    inFlight.erase(inFlight.begin() + k);
+                    update(move, result);
+                }
+            }
+            //after a cutoff the children still out are not needed, their owners notice the closed socket
+            for (const std::pair<int, Move> &child : inFlight) {
+                close(child.first);
+            }
+
+            Bound bound = bestScore <= alphaStart ? UpperBound : (bestScore >= beta ? LowerBound : ExactBound);
+            (*transpositionTable)[hash].Store(hash, bestMove, engine.scoreToTT(bestScore, ply), depth, bound);
+            return std::make_pair(bestLine, bestScore);
+        }
+
+        //one connection, requests answered one after the other until the other end closes it
+        void answer(int fd) {
+            SearchRequest request;
+            std::string fen;
+            while (receiveRequest(fd, request, fen)) {
+                StockDory::Board board(fen);
+                std::pair<std::array<Move, maxDepth>, int> result;
+                if (shards.empty()) {
+                    result = searchLocally(board, request.Alpha, request.Beta, request.Depth, request.Ply);
+                }
+                else if (board.ColorToMove() == White) {
+                    result = routedSearch<White>(board, request.Alpha, request.Beta, request.Depth, request.Ply);
+                }
+                else {
+                    result = routedSearch<Black>(board, request.Alpha, request.Beta, request.Depth, request.Ply);
+                }
+                //a line cut short by a table hit goes on as far as this worker's table knows it
+                if (board.ColorToMove() == White) {
+                    engine.extendLineTT<White, maxDepth>(*transpositionTable, board, result.first, 0, request.Depth);
+                }
+                else {
+                    engine.extendLineTT<Black, maxDepth>(*transpositionTable, board, result.first, 0, request.Depth);
+                }
+                if (not sendReply(fd, result, request.Depth)) {
+                    break;
+                }
+            }
+            close(fd);
+        }
+
+    public:
+        //the four ends of the protocol, public so the encoding can be checked over a socket pair
+        static bool sendRequest(int fd, const StockDory::Board &board, int alpha, int beta, int depth, int ply) {
+            std::string fen = board.Fen();
+            SearchRequest request = {alpha, beta, static_cast<int16_t>(depth), static_cast<int16_t>(ply), static_cast<uint16_t>(fen.size())};
+            std::array<uint8_t, SearchRequest::Size> header;
+            request.Encode(header.data());
+            return writeAll(fd, header.data(), header.size()) and writeAll(fd, fen.data(), fen.size());
+        }
+
+        static bool receiveRequest(int fd, SearchRequest &request, std::string &fen) {
+            std::array<uint8_t, SearchRequest::Size> header;
+            if (not readAll(fd, header.data(), header.size())) {
+                return false;
+            }
+            request = SearchRequest::Decode(header.data());
+            fen.assign(request.FenLength, ' ');
+            return readAll(fd, fen.data(), fen.size());
+        }
+
+        static bool sendReply(int fd, const std::pair<std::array<Move, maxDepth>, int> &result, int lineLength) {
+            SearchReply reply = {result.second, static_cast<uint8_t>(std::min<int>(std::max<int>(lineLength, 0), maxDepth))};
+            std::array<uint8_t, SearchReply::Size + 2 * maxDepth> message;
+            reply.Encode(message.data());
+            for (int i = 0; i < reply.LineLength; i++) {
+                PutBigEndian(message.data() + SearchReply::Size + 2 * i, packMove(result.first[i]), 2);
+            }
+            return writeAll(fd, message.data(), SearchReply::Size + 2 * reply.LineLength);
+        }
+
+        static bool receiveReply(int fd, std::pair<std::array<Move, maxDepth>, int> &result) {
+            std::array<uint8_t, SearchReply::Size> header;
+            if (not readAll(fd, header.data(), header.size())) {
+                return false;
+            }
+            SearchReply reply = SearchReply::Decode(header.data());
+            std::array<uint8_t, 2 * maxDepth> packed;
+            if (reply.LineLength > maxDepth or not readAll(fd, packed.data(), 2 * reply.LineLength)) {
+                return false;
+            }
+            result.first = std::array<Move, maxDepth>();
+            for (int i = 0; i < reply.LineLength; i++) {
+                result.first[i] = unpackMove(GetBigEndian(packed.data() + 2 * i, 2));
+            }
+            result.second = reply.Score;
+            return true;
+        }
+
+        ClusterSearch() = default;
+        ClusterSearch(const ClusterSearch &) = delete;
+        ClusterSearch &operator=(const ClusterSearch &) = delete;
+
+        ~ClusterSearch() {
+            for (int fd : workers) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+            }
+        }
+
+        static int listenOn(const std::string &address) {
+            return openSocket(address, true);
+        }
+
+        //transposition-driven -> addresses of every worker in shard order, the same list on the coordinator and on each
+        //worker. Positions at least routeDepth from the leaves are searched by their owner.
+        void setShards(const std::vector<std::string> &addresses, int depth = 4) {
+            shards = addresses;
+            routeDepth = std::max(1, depth);
+        }
+
+        bool addWorker(const std::string &address) {
+            int fd = openSocket(address, false);
+            if (fd < 0) {
+                return false;
+            }
+            workers.push_back(fd);
+            return true;
+        }
+
+        //worker loop -> answers requests from one coordinator at a time until it disconnects. In transposition-driven
+        //mode the other workers connect while a search runs and a worker waits for their answers while it is asked
+        //for more, so every connection gets a thread of its own. With once the first connection is the coordinator's
+        //and the worker stops when it closes.
+        void serve(int listenFd, bool once = false) {
+            if (shards.empty()) {
+                do {
+                    int fd = accept(listenFd, nullptr, nullptr);
+                    if (fd < 0) {
+                        return;
+                    }
+                    answer(fd);
+                } while (not once);
+                return;
+            }
+            //allocated before any thread probes it
+            transpositionTable = std::make_unique<NumaTranspositionTable<SearchEntry>>(16 * 1024 * 1024);
+            int coordinator = once ? accept(listenFd, nullptr, nullptr) : -1;
+            if (once and coordinator < 0) {
+                return;
+            }
+            std::thread peers([this, listenFd] {
+                while (true) {
+                    int fd = accept(listenFd, nullptr, nullptr);
+                    if (fd < 0) {
+                        return;
+                    }
+                    std::thread([this, fd] { answer(fd); }).detach();
+                }
+            });
+            if (not once) {
+                peers.join();
+                return;
+            }
+            peers.detach();
+            answer(coordinator);
+        }
+
+        //root splitting with the eldest brother first -> the first root move is searched alone to get a bound, the
+        //rest are handed out one per idle worker and results are taken in whatever order they finish
+        template<Color color>
+        std::pair<std::array<Move, maxDepth>, int> search(const StockDory::Board &chessBoard, int depth) {
+            const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
+            if (moveList.Count() == 0 or depth == 0 or workers.empty()) {
+                return searchLocally<color>(chessBoard, -50000, 50000, depth, 0);
+            }
+
+            int alpha = -50000;
+            int beta = 50000;
+            std::array<Move, maxDepth> bestLine;
+            int bestScore = -50000;
+
+            auto childBoard = [&](uint8_t i) {
+                StockDory::Board child = chessBoard;
+                child.Move<0>(moveList[i].From(), moveList[i].To(), moveList[i].Promotion());
+                return child;
+            };
+            auto update = [&](uint8_t i, std::pair<std::array<Move, maxDepth>, int> &result) {
+                result.second = -result.second;
+                if (result.second > bestScore) {
+                    bestScore = result.second;
+                    bestLine[0] = moveList[i];
+                    for (int j = 0; j < depth - 1; j++) {
+                        bestLine[j + 1] = result.first[j];
+                    }
+                    alpha = std::max(alpha, bestScore);
+                }
+            };
+            //a worker that fails is dropped and its move is searched here instead
+            auto dispatch = [&](size_t w, uint8_t i) {
+                if (workers[w] >= 0 and sendRequest(workers[w], childBoard(i), -beta, -alpha, depth - 1, 1)) {
+                    return true;
+                }
+                std::pair<std::array<Move, maxDepth>, int> result = searchLocally(childBoard(i), -beta, -alpha, depth - 1, 1);
+                update(i, result);
+                return false;
+            };
+
+            //a reply that never arrives is also searched here
+            auto collect = [&](size_t w, uint8_t i) {
+                std::pair<std::array<Move, maxDepth>, int> result;
+                if (not receiveReply(workers[w], result)) {
+                    close(workers[w]);
+                    workers[w] = -1;
+                    result = searchLocally(childBoard(i), -beta, -alpha, depth - 1, 1);
+                }
+                update(i, result);
+            };
+
+            if (dispatch(0, 0)) {
+                collect(0, 0);
+            }
+
+            std::vector<int> inFlight(workers.size(), -1);
+            uint8_t next = 1;
+            for (size_t w = 0; w < workers.size() and next < moveList.Count(); w++) {
+                uint8_t i = next++;
+                if (dispatch(w, i)) {
+                    inFlight[w] = i;
+                }
+            }
+            while (true) {
+                std::vector<pollfd> waiting;
+                std::vector<size_t> owner;
+                for (size_t w = 0; w < workers.size(); w++) {
+                    if (inFlight[w] >= 0) {
+                        waiting.push_back({workers[w], POLLIN, 0});
+                        owner.push_back(w);
+                    }
+                }
+                if (waiting.empty()) {
+                    break;
+                }
+                if (poll(waiting.data(), waiting.size(), -1) < 0) {
+                    continue;
+                }
+                for (size_t k = 0; k < waiting.size(); k++) {
+                    if (waiting[k].revents == 0) {
+                        continue;
+                    }
+                    size_t w = owner[k];
+                    collect(w, inFlight[w]);
+                    inFlight[w] = -1;
+                    //keep the worker busy with the next root move, searched with the bound proven so far
+                    while (next < moveList.Count()) {
+                        uint8_t i = next++;
+                        if (dispatch(w, i)) {
+                            inFlight[w] = i;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            return std::make_pair(bestLine, bestScore);
+        }
+
+        //transposition-driven iterative deepening -> the root goes to its owner every iteration, the shards keep the
+        //results and best moves of the earlier iterations for the positions they own
+        template<Color color>
+        std::pair<std::array<Move, maxDepth>, int> transpositionDriven(const StockDory::Board &chessBoard, int depth) {
+            std::pair<std::array<Move, maxDepth>, int> result;
+            for (int d = 1; d <= depth; d++) {
+                int fd = shards.empty() ? -1 : sendToOwner(chessBoard, -50000, 50000, d, 0);
+                bool received = fd >= 0 and receiveReply(fd, result);
+                if (fd >= 0) {
+                    close(fd);
+                }
+                if (not received) {
+                    result = searchLocally<color>(chessBoard, -50000, 50000, d, 0);
+                }
+            }
+            return result;
+        }
+};
+
+#endif
+
+#endif //CLUSTERSEARCH_H
@@ -5,24 +5,110 @@
 #ifndef ENGINE_H
 #define ENGINE_H
 #include <limits>
+#include <algorithm>
 
 #include "Backend/Board.h"
 #include "Backend/Type/Move.h"
 #include "Backend/Type/Color.h"
+#include "Backend/TranspositionTable.h"
 #include "Evaluation.h"
+#include "SearchEntry.h"
+#include <atomic>
+#include <mutex>
 #include <utility>
+#include <vector>
 #include <omp.h>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
 
+#include "SharedTranspositionTable.h"
+#endif
+
+
+#include "NumaTranspositionTable.h"
 #include "SimplifiedMoveList.h"
+#include "MovePicker.h"
+#include "WorkStealingDeque.h"
+#include "ThreadTeam.h"
+
+//a move at the root and the nodes its subtree took in the last iteration
+struct RootMove {
+    Move move;
+    uint64_t nodes = 0;
+};
+
+//expected node type (Knuth and Moore) -> PV nodes have an exact score, at a CUT node one move is enough to refute it,
+//at an ALL node every move has to be searched. Only PV and ALL nodes are worth splitting.
+enum NodeType : uint8_t {
+    PVNode,
+    CutNode,
+    AllNode
+};
 
 class Engine {
     private:
         Evaluation evaluation;
+        //nodes searched by this thread, the difference around a subtree is its size
+        static inline thread_local uint64_t nodeCount = 0;
+        //two quiet moves per ply that caused a cutoff, one set per thread since threads share the engine
+        static inline thread_local std::array<std::array<Move, 2>, 256> killers;
+        //set by a speculative root search, once raised the searches of this thread give up and store nothing
+        static inline thread_local const std::atomic<bool> *cancelled = nullptr;
         int numThreads = 8;
-        int mateScore = 20000;
+        //moves a predicted CUT node tries on its own before it is taken for an ALL node and split
+        int cutNodeSerialMoves = 3;
+        //split points this close to the leaves search their moves themselves
+        int minSplitDepth = 2;
+        //scores within maxPly of mateScore are mate scores
+        int maxPly = 256;
 
     public:
+        //score of being mated at the root, a mate n plies away is worth n less
+        int mateScore = 20000;
+
+        //mate scores are relative to the root, the table stores them relative to the node so an entry is valid at any ply
+        int scoreToTT(int score, int ply) const {
+            if (score >= mateScore - maxPly) {
+                return score + ply;
+            }
+            if (score <= -mateScore + maxPly) {
+                return score - ply;
+            }
+            return score;
+        }
+
+        //the first child of a PV node is a PV node and its brothers are CUT nodes,
+        //the children of a CUT node are ALL nodes and the children of an ALL node are CUT nodes
+        static NodeType childType(NodeType type, int index) {
+            if (type == PVNode) {
+                return index == 0 ? PVNode : CutNode;
+            }
+            return type == CutNode ? AllNode : CutNode;
+        }
+
+        //moves searched one after the other before a node may split
+        uint8_t serialMoves(NodeType type, uint8_t moveCount) const {
+            return std::min<int>(type == CutNode ? cutNodeSerialMoves : 1, moveCount);
+        }
+
+        static bool isCancelled() {
+            return cancelled != nullptr and cancelled->load(std::memory_order_relaxed);
+        }
+
+        int scoreFromTT(int score, int ply) const {
+            if (score >= mateScore - maxPly) {
+                return score - ply;
+            }
+            if (score <= -mateScore + maxPly) {
+                return score + ply;
+            }
+            return score;
+        }
+
         template<Color color>
         int minimaxMoveCounter(StockDory::Board &chessBoard, int depth) {
             int sum = 0;
@@ -92,7 +178,7 @@ class Engine {
         }
         //minimax implementation
         template<Color color, int maxDepth>
-        std::pair<std::array<Move, maxDepth>, int> minimax(StockDory::Board &chessBoard, int depth) {
+        std::pair<std::array<Move, maxDepth>, int> minimax(StockDory::Board &chessBoard, int depth, int ply = 0) {
             std::array<Move, maxDepth> bestLine;
             int bestScore;
             int bestLineSize;
@@ -105,7 +191,7 @@ class Engine {
 
                 // Add check for no legal moves
                 if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
-                    return std::make_pair(std::array<Move, maxDepth>(), -mateScore-depth);
+                    return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
                 }
                 else if (moveList.Count() == 0) {
                     // No legal moves
@@ -126,7 +212,7 @@ class Engine {
                     Piece promotion = nextMove.Promotion();
                     // Perform move
                     PreviousState prevState = chessBoard.Move<0>(from, to, promotion);
-                    std::pair<std::array<Move, maxDepth>, int> result = minimax<Ocolor, maxDepth>(chessBoard, depth-1);
+                    std::pair<std::array<Move, maxDepth>, int> result = minimax<Ocolor, maxDepth>(chessBoard, depth-1, ply + 1);
                     // Update best score
                     if (bestScore < result.second) {
                         bestScore = result.second;
@@ -147,7 +233,7 @@ class Engine {
 
                 // Add check for no legal moves
                 if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
-                    return std::make_pair(std::array<Move, maxDepth>(), mateScore+depth);
+                    return std::make_pair(std::array<Move, maxDepth>(), mateScore-ply);
                 }
                 else if (moveList.Count() == 0) {
                     // No legal moves
@@ -168,7 +254,7 @@ class Engine {
                     Piece promotion = nextMove.Promotion();
                     // Perform move
                     PreviousState prevState = chessBoard.Move<0>(from, to, promotion);
-                    std::pair<std::array<Move, maxDepth>, int> result = minimax<Ocolor, maxDepth>(chessBoard, depth-1);
+                    std::pair<std::array<Move, maxDepth>, int> result = minimax<Ocolor, maxDepth>(chessBoard, depth-1, ply + 1);
                     // Update best score
                     if (bestScore > result.second) {
                         bestScore = result.second;
@@ -187,7 +273,7 @@ class Engine {
         }
 
         template<Color color, int maxDepth>
-        std::pair<std::array<Move, maxDepth>, int> parallelMinimax(StockDory::Board &chessBoard, int depth) {
+        std::pair<std::array<Move, maxDepth>, int> parallelMinimax(StockDory::Board &chessBoard, int depth, int ply = 0) {
             // Local variables
             std::array<Move, maxDepth> bestLine;
             int bestScore;
@@ -201,7 +287,7 @@ class Engine {
 
                 // Add check for no legal moves
                 if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
-                    return std::make_pair(std::array<Move, maxDepth>(), -mateScore-depth);
+                    return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
                 }
                 else if (moveList.Count() == 0) {
                     // No legal moves
@@ -223,7 +309,7 @@ class Engine {
                     Piece promotion = nextMove.Promotion();
                     // Perform move
                     PreviousState prevState = localBoard.Move<0>(from, to, promotion);
-                    std::pair<std::array<Move, maxDepth>, int> result = minimax<Ocolor, maxDepth>(localBoard, depth-1);
+                    std::pair<std::array<Move, maxDepth>, int> result = minimax<Ocolor, maxDepth>(localBoard, depth-1, ply + 1);
                     // Update best score
 #pragma omp critical
                     {
@@ -247,7 +333,7 @@ class Engine {
 
                 // Add check for no legal moves
                 if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
-                    return std::make_pair(std::array<Move, maxDepth>(), mateScore+depth);
+                    return std::make_pair(std::array<Move, maxDepth>(), mateScore-ply);
                 }
                 else if (moveList.Count() == 0) {
                     // No legal moves
@@ -269,7 +355,7 @@ class Engine {
                     Piece promotion = nextMove.Promotion();
                     // Perform move
                     PreviousState prevState = localBoard.Move<0>(from, to, promotion);
-                    std::pair<std::array<Move, maxDepth>, int> result = minimax<Ocolor, maxDepth>(localBoard, depth-1);
+                    std::pair<std::array<Move, maxDepth>, int> result = minimax<Ocolor, maxDepth>(localBoard, depth-1, ply + 1);
                     // Update best score
                     #pragma omp critical
                     {
@@ -361,16 +447,24 @@ class Engine {
         }
 
         template<Color color, int maxDepth>
-        std::pair<std::array<Move, maxDepth>, int> alphaBetaNegaMoveCounter(StockDory::Board &chessBoard, int alpha, int beta, int depth, int &count) {
+        std::pair<std::array<Move, maxDepth>, int> alphaBetaNegaMoveCounter(StockDory::Board &chessBoard, int alpha, int beta, int depth, int &count, int ply = 0) {
              //local variable of best line and best score
              int bestScore;
              std::array<Move, maxDepth> bestLine;
              int bestLineSize;
+             //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+             if (ply > 0) {
+                 alpha = std::max(alpha, -mateScore + ply);
+                 beta = std::min(beta, mateScore - ply - 1);
+                 if (alpha >= beta) {
+                     return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                 }
+             }
              //create move list for player
              const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
              //check for mate
              if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
-                 return std::make_pair(std::array<Move, maxDepth>(), -mateScore-depth);
+                 return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
              }
              //stalemate
              else if (moveList.Count() == 0){
@@ -398,7 +492,7 @@ class Engine {
                  Piece promotion = nextMove.Promotion();
                  //Perform move
                  PreviousState prevState = chessBoard.Move<0>(from, to, promotion);
-                 std::pair<std::array<Move, maxDepth>, int> result = alphaBetaNegaMoveCounter<Ocolor, maxDepth>(chessBoard, -beta, -alpha, depth-1, count);
+                 std::pair<std::array<Move, maxDepth>, int> result = alphaBetaNegaMoveCounter<Ocolor, maxDepth>(chessBoard, -beta, -alpha, depth-1, count, ply + 1);
                  //update if we found a better move for white
                  result.second = -result.second;
                  if (bestScore < result.second) {
@@ -424,16 +518,25 @@ class Engine {
          }
 
         template<Color color, int maxDepth>
-        std::pair<std::array<Move, maxDepth>, int> alphaBetaNega(StockDory::Board &chessBoard, int alpha, int beta, int depth) {
+        std::pair<std::array<Move, maxDepth>, int> alphaBetaNega(StockDory::Board &chessBoard, int alpha, int beta, int depth, int ply = 0) {
+             nodeCount++;
              //local variable of best line and best score
              int bestScore;
              std::array<Move, maxDepth> bestLine;
              int bestLineSize;
+             //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+             if (ply > 0) {
+                 alpha = std::max(alpha, -mateScore + ply);
+                 beta = std::min(beta, mateScore - ply - 1);
+                 if (alpha >= beta) {
+                     return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                 }
+             }
              //create move list for player
              const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
              //check for mate
              if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
-                 return std::make_pair(std::array<Move, maxDepth>(), -mateScore-depth);
+                 return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
              }
              //stalemate
              else if (moveList.Count() == 0){
@@ -460,7 +563,7 @@ class Engine {
                  Piece promotion = nextMove.Promotion();
                  //Perform move
                  PreviousState prevState = chessBoard.Move<0>(from, to, promotion);
-                 std::pair<std::array<Move, maxDepth>, int> result = alphaBetaNega<Ocolor, maxDepth>(chessBoard, -beta, -alpha, depth-1);
+                 std::pair<std::array<Move, maxDepth>, int> result = alphaBetaNega<Ocolor, maxDepth>(chessBoard, -beta, -alpha, depth-1, ply + 1);
                  //update if we found a better move for white
                  result.second = -result.second;
                  if (bestScore < result.second) {
@@ -485,15 +588,421 @@ class Engine {
              return std::make_pair(bestLine, bestScore);
          }
     
+        template<Color color, int maxDepth, typename Table>
+        std::pair<std::array<Move, maxDepth>, int> alphaBetaNegaTT(Table &table, StockDory::Board &chessBoard, int alpha, int beta, int depth, int ply = 0) {
+             //local variable of best line and best score
+             int bestScore;
+             std::array<Move, maxDepth> bestLine;
+             int bestLineSize;
+             Move bestMove;
+             const ZobristHash hash = chessBoard.Zobrist();
+             //a cancelled search is thrown away, the score does not matter
+             if (isCancelled()) {
+                 return std::make_pair(std::array<Move, maxDepth>(), alpha);
+             }
+             //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+             if (ply > 0) {
+                 alpha = std::max(alpha, -mateScore + ply);
+                 beta = std::min(beta, mateScore - ply - 1);
+                 if (alpha >= beta) {
+                     return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                 }
+             }
+             const int alphaStart = alpha;
+             //probe the table -> an entry searched at least as deep can answer for this node
+             SearchHit hit;
+             const bool found = table[hash].Probe(hash, hit);
+             if (found and ply > 0 and hit.Depth >= depth) {
+                 int score = scoreFromTT(hit.Score, ply);
+                 if (hit.Type == ExactBound or (hit.Type == LowerBound and score >= beta) or (hit.Type == UpperBound and score <= alpha)) {
+                     bestLine[0] = hit.BestMove;
+                     return std::make_pair(bestLine, score);
+                 }
+             }
+             constexpr enum Color Ocolor = Opposite(color);
+             bestScore = -50000;
+             //searches one child, true on a cutoff
+             auto searchMove = [&](Move nextMove) {
+                 Square from = nextMove.From();
+                 Square to = nextMove.To();
+                 Piece promotion = nextMove.Promotion();
+                 //Perform move, the hash has to be kept up to date for the children to probe
+                 PreviousState prevState = chessBoard.Move<ZOBRIST>(from, to, promotion);
+                 std::pair<std::array<Move, maxDepth>, int> result = alphaBetaNegaTT<Ocolor, maxDepth>(table, chessBoard, -beta, -alpha, depth-1, ply + 1);
+                 result.second = -result.second;
+                 if (bestScore < result.second) {
+                     //create chess line with the current move as the head
+                     bestLine[0] = nextMove;
+                     //append result line to the current move
+                     bestLineSize = 1;
+                     for (int j = 0; j < depth - 1; j++) {
+                         bestLine[bestLineSize++] = result.first[j];
+                     }
+                     bestScore = result.second;
+                     bestMove = nextMove;
+                 }
+                 //Undo move
+                 chessBoard.UndoMove<ZOBRIST>(prevState, from, to);
+                 //alpha check
+                 alpha = std::max(alpha, result.second);
+                 return beta <= alpha;
+             };
+             //base-case -> when depth is 0, we evaluate the position score and return a default move (which will be overrided in the parent call)
+             if (depth == 0) {
+                 const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
+                 //check for mate
+                 if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
+                     return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
+                 }
+                 //stalemate
+                 else if (moveList.Count() == 0){
+                     return std::make_pair(std::array<Move, maxDepth>(), 0);
+                 }
+                 int score = evaluation.eval(chessBoard);
+                 //flip the score for black since we are maximizing
+                 if (color == Black) {
+                     score *= -1;
+                 }
+                 return std::make_pair(std::array<Move, maxDepth>(), score);
+             }
+             //moves come in stages: the stored move, good captures, killers, then the rest.
+             //A cutoff early on means the quiet moves are never generated.
+             std::array<Move, 2> &plyKillers = killers[std::min<int>(ply, killers.size() - 1)];
+             MovePicker<color> picker(chessBoard, found ? hit.BestMove : Move(), plyKillers);
+             Move nextMove;
+             bool anyMove = false;
+             while (picker.next(nextMove)) {
+                 anyMove = true;
+                 if (searchMove(nextMove)) {
+                     //a quiet move that refutes this node is likely to refute its siblings too
+                     if (picker.quiet(nextMove) and not (plyKillers[0] == nextMove)) {
+                         plyKillers[1] = plyKillers[0];
+                         plyKillers[0] = nextMove;
+                     }
+                     break;
+                 }
+             }
+             //check for mate
+             if (not anyMove and chessBoard.Checked<color>()) {
+                 return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
+             }
+             //stalemate
+             else if (not anyMove) {
+                 return std::make_pair(std::array<Move, maxDepth>(), 0);
+             }
+
+             //children cut short by a cancel would leave a wrong score in the table
+             if (isCancelled()) {
+                 return std::make_pair(bestLine, bestScore);
+             }
+             Bound bound = bestScore <= alphaStart ? UpperBound : (bestScore >= beta ? LowerBound : ExactBound);
+             table[hash].Store(hash, bestMove, scoreToTT(bestScore, ply), depth, bound);
+
+             return std::make_pair(bestLine, bestScore);
+         }
+
+        template<Color color, int maxDepth, typename Table>
+        std::pair<std::array<Move, maxDepth>, int> iterativeDeepeningTT(Table &table, StockDory::Board &chessBoard, int depth) {
+            std::pair<std::array<Move, maxDepth>, int> result;
+            //each iteration leaves best moves in the table that order the next, deeper one
+            for (int d = 1; d <= depth; d++) {
+                result = alphaBetaNegaTT<color, maxDepth>(table, chessBoard, -50000, 50000, d);
+            }
+            extendLineTT<color, maxDepth>(table, chessBoard, result.first, 0, depth);
+            return result;
+        }
+
+        //the search line stops wherever a table hit answered a node, the rest is filled in by following stored best moves
+        template<Color color, int maxDepth, typename Table>
+        void extendLineTT(Table &table, StockDory::Board &chessBoard, std::array<Move, maxDepth> &line, int index, int depth) {
+            if (index >= depth or index >= maxDepth) {
+                return;
+            }
+            Move nextMove = line[index];
+            if (nextMove == Move()) {
+                SearchHit hit;
+                if (not table[chessBoard.Zobrist()].Probe(chessBoard.Zobrist(), hit)) {
+                    return;
+                }
+                nextMove = hit.BestMove;
+            }
+            //a stored move can come from a hash collision, only follow it if it is legal here
+            const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
+            bool legal = false;
+            for (uint8_t i = 0; i < moveList.Count(); i++) {
+                legal = legal or moveList[i] == nextMove;
+            }
+            if (not legal) {
+                std::fill(line.begin() + index, line.end(), Move());
+                return;
+            }
+            line[index] = nextMove;
+            constexpr enum Color Ocolor = Opposite(color);
+            PreviousState prevState = chessBoard.Move<ZOBRIST>(nextMove.From(), nextMove.To(), nextMove.Promotion());
+            extendLineTT<Ocolor, maxDepth>(table, chessBoard, line, index + 1, depth);
+            chessBoard.UndoMove<ZOBRIST>(prevState, nextMove.From(), nextMove.To());
+        }
+
+        //MTD(f) -> only zero window searches, each one moves a bound on the true score until both bounds meet.
+        //The table keeps what every pass proved so the later passes re-search very little.
+        template<Color color, int maxDepth, typename Table>
+        std::pair<std::array<Move, maxDepth>, int> mtdf(Table &table, StockDory::Board &chessBoard, int guess, int depth) {
+            std::pair<std::array<Move, maxDepth>, int> best;
+            int lower = -50000;
+            int upper = 50000;
+            int score = guess;
+            while (lower < upper) {
+                int beta = score == lower ? score + 1 : score;
+                std::pair<std::array<Move, maxDepth>, int> result = alphaBetaNegaTT<color, maxDepth>(table, chessBoard, beta - 1, beta, depth);
+                score = result.second;
+                if (score < beta) {
+                    upper = score;
+                }
+                else {
+                    //a fail high proves its move reaches the score, that is the line to keep
+                    lower = score;
+                    best = result;
+                }
+            }
+            best.second = lower;
+            //below the first move a zero window line is only a refutation, the table has the real continuation
+            std::fill(best.first.begin() + 1, best.first.end(), Move());
+            extendLineTT<color, maxDepth>(table, chessBoard, best.first, 0, depth);
+            return best;
+        }
+
+        template<Color color, int maxDepth, typename Table>
+        std::pair<std::array<Move, maxDepth>, int> iterativeMTDF(Table &table, StockDory::Board &chessBoard, int depth) {
+            std::pair<std::array<Move, maxDepth>, int> result;
+            //the score of the previous iteration is the first guess of the next
+            for (int d = 1; d <= depth; d++) {
+                result = mtdf<color, maxDepth>(table, chessBoard, result.second, d);
+            }
+            return result;
+        }
+
+        //parallel MTD(f) -> every thread runs a zero window search at its own test value, all of them into one table.
+        //A round ends with the highest fail high as the lower bound and the lowest fail low as the upper bound.
+        template<Color color, int maxDepth, typename Table>
+        std::pair<std::array<Move, maxDepth>, int> parallelMTDF(Table &table, const StockDory::Board &chessBoard, int guess, int depth) {
+            std::pair<std::array<Move, maxDepth>, int> best;
+            int lower = -50000;
+            int upper = 50000;
+            int probes = std::max(1, omp_get_max_threads());
+            //spacing of the test values around the guess while one side is still unbounded
+            int width = 16;
+            while (lower < upper) {
+                //test values in (lower, upper], the guess is always one of them
+                std::vector<int> betas;
+                if (upper - lower <= probes) {
+                    for (int beta = lower + 1; beta <= upper; beta++) {
+                        betas.push_back(beta);
+                    }
+                }
+                else if (lower > -50000 and upper < 50000) {
+                    for (int k = 1; k <= probes; k++) {
+                        betas.push_back(lower + (int) ((long long) (upper - lower) * k / (probes + 1)) + 1);
+                    }
+                }
+                else {
+                    guess = std::clamp(guess, lower + 1, upper);
+                    for (int k = 0; k < probes; k++) {
+                        betas.push_back(std::clamp(guess + (k - (probes - 1) / 2) * width, lower + 1, upper));
+                    }
+                    width *= 2;
+                }
+                std::sort(betas.begin(), betas.end());
+                betas.erase(std::unique(betas.begin(), betas.end()), betas.end());
+
+                int roundLower = lower;
+                int roundUpper = upper;
+                #pragma omp parallel for schedule(dynamic)
+                for (size_t i = 0; i < betas.size(); i++) {
+                    //Private copy of the board for each thread
+                    StockDory::Board threadBoard = chessBoard;
+                    std::pair<std::array<Move, maxDepth>, int> result = alphaBetaNegaTT<color, maxDepth>(table, threadBoard, betas[i] - 1, betas[i], depth);
+                    #pragma omp critical
+                    {
+                        if (result.second >= betas[i]) {
+                            if (result.second > roundLower) {
+                                roundLower = result.second;
+                                best = result;
+                            }
+                        }
+                        else {
+                            roundUpper = std::min(roundUpper, result.second);
+                        }
+                    }
+                }
+                //a probe can run into entries of another one and come back with a bound the other side already beat
+                lower = roundLower;
+                upper = std::max(roundUpper, lower);
+                guess = lower > -50000 ? lower : upper;
+            }
+            best.second = lower;
+            std::fill(best.first.begin() + 1, best.first.end(), Move());
+            StockDory::Board lineBoard = chessBoard;
+            extendLineTT<color, maxDepth>(table, lineBoard, best.first, 0, depth);
+            return best;
+        }
+
+        template<Color color, int maxDepth, typename Table>
+        std::pair<std::array<Move, maxDepth>, int> iterativeParallelMTDF(Table &table, const StockDory::Board &chessBoard, int depth) {
+            std::pair<std::array<Move, maxDepth>, int> result;
+            for (int d = 1; d <= depth; d++) {
+                result = parallelMTDF<color, maxDepth>(table, chessBoard, result.second, d);
+            }
+            return result;
+        }
+
+        //aspiration windows -> search with a narrow window around the guess and widen it on the side that failed
+        template<Color color, int maxDepth, typename Table>
+        std::pair<std::array<Move, maxDepth>, int> aspiration(Table &table, StockDory::Board &chessBoard, int guess, int depth) {
+            int width = 25;
+            int alpha = std::max(-50000, guess - width);
+            int beta = std::min(50000, guess + width);
+            while (true) {
+                std::pair<std::array<Move, maxDepth>, int> result = alphaBetaNegaTT<color, maxDepth>(table, chessBoard, alpha, beta, depth);
+                if (result.second <= alpha and alpha > -50000) {
+                    alpha = std::max(-50000, alpha - width);
+                }
+                else if (result.second >= beta and beta < 50000) {
+                    beta = std::min(50000, beta + width);
+                }
+                else {
+                    extendLineTT<color, maxDepth>(table, chessBoard, result.first, 0, depth);
+                    return result;
+                }
+                width *= 2;
+            }
+        }
+
+        template<Color color, int maxDepth, typename Table>
+        std::pair<std::array<Move, maxDepth>, int> iterativeAspiration(Table &table, StockDory::Board &chessBoard, int depth) {
+            std::pair<std::array<Move, maxDepth>, int> result;
+            result.second = 0;
+            for (int d = 1; d <= depth; d++) {
+                result = aspiration<color, maxDepth>(table, chessBoard, result.second, d);
+            }
+            return result;
+        }
+
+        //speculative aspiration windows -> instead of re-searching after a fail, every thread searches the root at once
+        //with its own window: a narrow one around the guess, then windows shifted up and down, each twice as far out,
+        //and the outermost ones open ended. Neighbouring windows overlap by one so every score is strictly inside one.
+        //The first search that ends inside its window has the exact score, the others are cancelled.
+        template<Color color, int maxDepth, typename Table>
+        std::pair<std::array<Move, maxDepth>, int> parallelAspiration(Table &table, const StockDory::Board &chessBoard, int guess, int depth) {
+            int windows = std::max(1, omp_get_max_threads());
+            guess = std::clamp(guess, -49999, 49999);
+            //edges between neighbouring windows, spreading out from the guess
+            std::vector<int> edges = {-50000, 50000};
+            for (int offset = 25, k = 0; (int) edges.size() < windows + 1 and offset < 100000; k++) {
+                int edge = k % 2 == 0 ? guess - offset : guess + offset;
+                if (edge > -50000 and edge < 50000) {
+                    edges.push_back(edge);
+                }
+                if (k % 2 == 1) {
+                    offset = offset * 2 + 25;
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+            std::vector<std::pair<int, int>> bounds;
+            for (size_t i = 0; i + 1 < edges.size(); i++) {
+                bounds.emplace_back(i == 0 ? edges[i] : edges[i] - 1, edges[i + 1]);
+            }
+            //the window around the guess first, in case there are fewer threads than windows
+            std::stable_sort(bounds.begin(), bounds.end(), [guess](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+                bool aInside = a.first < guess and guess < a.second;
+                bool bInside = b.first < guess and guess < b.second;
+                return aInside and not bInside;
+            });
+
+            std::pair<std::array<Move, maxDepth>, int> best;
+            std::atomic<bool> found{false};
+            #pragma omp parallel for schedule(dynamic) num_threads(bounds.size())
+            for (size_t i = 0; i < bounds.size(); i++) {
+                if (found.load(std::memory_order_relaxed)) {
+                    continue;
+                }
+                //Private copy of the board for each thread
+                StockDory::Board threadBoard = chessBoard;
+                cancelled = &found;
+                std::pair<std::array<Move, maxDepth>, int> result = alphaBetaNegaTT<color, maxDepth>(table, threadBoard, bounds[i].first, bounds[i].second, depth);
+                cancelled = nullptr;
+                //a cancelled search only returns after found was raised, so it can never win here
+                if (result.second > bounds[i].first and result.second < bounds[i].second and not found.exchange(true)) {
+                    best = result;
+                }
+            }
+            //entries written by the other windows can make neighbouring windows fail on opposite sides
+            if (not found.load()) {
+                StockDory::Board threadBoard = chessBoard;
+                best = alphaBetaNegaTT<color, maxDepth>(table, threadBoard, -50000, 50000, depth);
+            }
+            StockDory::Board lineBoard = chessBoard;
+            extendLineTT<color, maxDepth>(table, lineBoard, best.first, 0, depth);
+            return best;
+        }
+
+        template<Color color, int maxDepth, typename Table>
+        std::pair<std::array<Move, maxDepth>, int> iterativeParallelAspiration(Table &table, const StockDory::Board &chessBoard, int depth) {
+            std::pair<std::array<Move, maxDepth>, int> result;
+            result.second = 0;
+            for (int d = 1; d <= depth; d++) {
+                result = parallelAspiration<color, maxDepth>(table, chessBoard, result.second, d);
+            }
+            return result;
+        }
+
+#if defined(__unix__) || defined(__APPLE__)
+        //Lazy SMP across processes -> helper processes run their own searches into a table in shared memory and the
+        //main process picks their results up through it. A helper that crashes only loses its own search.
+        template<Color color, int maxDepth>
+        std::pair<std::array<Move, maxDepth>, int> sharedMemoryLazySMP(const StockDory::Board &chessBoard, int depth, int processes) {
+            SharedTranspositionTable<SearchEntry> table("/multicorechess-" + std::to_string(getpid()), 16 * 1024 * 1024);
+            std::vector<pid_t> helpers;
+            for (int p = 1; p < processes; p++) {
+                pid_t pid = fork();
+                if (pid == 0) {
+                    //half the helpers search one ply deeper so they do not walk the same tree in lockstep
+                    StockDory::Board helperBoard = chessBoard;
+                    iterativeDeepeningTT<color, maxDepth>(table, helperBoard, depth + p % 2);
+                    _exit(0);
+                }
+                if (pid > 0) {
+                    helpers.push_back(pid);
+                }
+            }
+            StockDory::Board mainBoard = chessBoard;
+            std::pair<std::array<Move, maxDepth>, int> result = iterativeDeepeningTT<color, maxDepth>(table, mainBoard, depth);
+            //the main search is authoritative, helpers still running are no longer useful
+            for (pid_t pid : helpers) {
+                kill(pid, SIGKILL);
+                waitpid(pid, nullptr, 0);
+            }
+            return result;
+        }
+#endif
+
         template<Color color, int maxDepth>
-        std::pair<std::array<Move, maxDepth>, int> naiveParallelAlphaBeta(const StockDory::Board &chessBoard, int alpha, int beta, int depth) {
+        std::pair<std::array<Move, maxDepth>, int> naiveParallelAlphaBeta(const StockDory::Board &chessBoard, int alpha, int beta, int depth, int ply = 0, std::vector<RootMove> *rootMoves = nullptr) {
             std::array<Move, maxDepth> bestLine;
             int bestScore = -50000;
+            //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+            if (ply > 0) {
+                alpha = std::max(alpha, -mateScore + ply);
+                beta = std::min(beta, mateScore - ply - 1);
+                if (alpha >= beta) {
+                    return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                }
+            }
             // create move list for player
             const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
              //check for mate
             if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
-                return std::make_pair(std::array<Move, maxDepth>(), -mateScore-depth);
+                return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
             }
             //stalemate
             else if (moveList.Count() == 0){
@@ -508,10 +1017,15 @@ class Engine {
             }
 
             constexpr enum Color Ocolor = Opposite(color);
+            //at the root the caller may hand in the moves already ordered, their subtree sizes are recorded for the next iteration
+            const uint8_t moveCount = rootMoves ? rootMoves->size() : moveList.Count();
+            auto moveAt = [&](uint8_t i) {
+                return rootMoves ? (*rootMoves)[i].move : moveList[i];
+            };
 
             //Dynamic schedule since we do not know the ordering of moves or the number of moves in each call
             #pragma omp parallel for shared(alpha, beta) schedule(dynamic)
-            for (uint8_t i = 0; i < moveList.Count(); i++) {
+            for (uint8_t i = 0; i < moveCount; i++) {
                 // int thread = omp_get_thread_num();
                 // // printf("%d\n", thread);
                 // printf("I hit the for loop for thread %d \n", thread);
@@ -520,12 +1034,16 @@ class Engine {
                 }
                 //Private copy of the board for each thread
                 StockDory::Board threadBoard = chessBoard;
-                Move nextMove = moveList[i];
+                Move nextMove = moveAt(i);
                 Square from = nextMove.From();
                 Square to = nextMove.To();
                 Piece promotion = nextMove.Promotion();
                 PreviousState prevState = threadBoard.Move<0>(from, to, promotion);
-                std::pair<std::array<Move, maxDepth>, int> localResult = alphaBetaNega<Ocolor, maxDepth>(threadBoard, -beta, -alpha, depth - 1);
+                uint64_t nodesBefore = nodeCount;
+                std::pair<std::array<Move, maxDepth>, int> localResult = alphaBetaNega<Ocolor, maxDepth>(threadBoard, -beta, -alpha, depth - 1, ply + 1);
+                if (rootMoves) {
+                    (*rootMoves)[i].nodes = nodeCount - nodesBefore;
+                }
                 localResult.second = -localResult.second;
                 threadBoard.UndoMove<0>(prevState, from, to);
                 #pragma omp critical
@@ -545,14 +1063,22 @@ class Engine {
         }
 
         template<Color color, int maxDepth>
-        std::pair<std::array<Move, maxDepth>, int> naiveParallelYBAlphaBeta(const StockDory::Board &chessBoard, int alpha, int beta, int depth) {
+        std::pair<std::array<Move, maxDepth>, int> naiveParallelYBAlphaBeta(const StockDory::Board &chessBoard, int alpha, int beta, int depth, int ply = 0) {
             std::array<Move, maxDepth> bestLine;
             int bestScore = -50000;
+            //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+            if (ply > 0) {
+                alpha = std::max(alpha, -mateScore + ply);
+                beta = std::min(beta, mateScore - ply - 1);
+                if (alpha >= beta) {
+                    return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                }
+            }
             // create move list for player
             const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
              //check for mate
             if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
-                return std::make_pair(std::array<Move, maxDepth>(), -mateScore-depth);
+                return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
             }
             //stalemate
             else if (moveList.Count() == 0){
@@ -576,7 +1102,7 @@ class Engine {
             //create local copy for safety
             StockDory::Board boardCopy = chessBoard;
             PreviousState prevState = boardCopy.Move<0>(from, to, promotion);
-            std::pair<std::array<Move, maxDepth>, int> result = naiveParallelYBAlphaBeta<Ocolor, maxDepth>(boardCopy, -beta, -alpha, depth - 1);
+            std::pair<std::array<Move, maxDepth>, int> result = naiveParallelYBAlphaBeta<Ocolor, maxDepth>(boardCopy, -beta, -alpha, depth - 1, ply + 1);
             result.second = -result.second;
             boardCopy.UndoMove<0>(prevState, from, to);
             if (result.second > bestScore) {
@@ -608,7 +1134,7 @@ class Engine {
                 Square to = nextMove.To();
                 Piece promotion = nextMove.Promotion();
                 PreviousState prevState = threadBoard.Move<0>(from, to, promotion);
-                std::pair<std::array<Move, maxDepth>, int> localResult = alphaBetaNega<Ocolor, maxDepth>(threadBoard, -beta, -alpha, depth - 1);
+                std::pair<std::array<Move, maxDepth>, int> localResult = alphaBetaNega<Ocolor, maxDepth>(threadBoard, -beta, -alpha, depth - 1, ply + 1);
                 localResult.second = -localResult.second;
                 threadBoard.UndoMove<0>(prevState, from, to);
                 #pragma omp critical
@@ -627,15 +1153,359 @@ class Engine {
             return std::make_pair(bestLine, bestScore);
         }
 
+        //YBWC with a helpful master -> the moves of a split point become tied tasks and the thread that opened it waits in
+        //taskwait. A thread suspended there may only pick up tasks that descend from the task it is waiting in, so instead
+        //of idling at a barrier it helps with the split point's own subtrees, the ones its helpers opened included.
+        template<Color color, int maxDepth>
+        std::pair<std::array<Move, maxDepth>, int> YBWC(const StockDory::Board &chessBoard, int alpha, int beta, int depth, int ply = 0, std::vector<RootMove> *rootMoves = nullptr, NodeType type = PVNode) {
+            std::pair<std::array<Move, maxDepth>, int> result;
+            //one team for the whole search, every split point below hands its moves to it
+            #pragma omp parallel
+            #pragma omp single
+            result = YBWCSearch<color, maxDepth>(chessBoard, alpha, beta, depth, ply, rootMoves, type);
+            return result;
+        }
+
         template<Color color, int maxDepth>
-        std::pair<std::array<Move, maxDepth>, int> YBWC(const StockDory::Board &chessBoard, int alpha, int beta, int depth) {
+        std::pair<std::array<Move, maxDepth>, int> YBWCSearch(const StockDory::Board &chessBoard, int alpha, int beta, int depth, int ply = 0, std::vector<RootMove> *rootMoves = nullptr, NodeType type = PVNode, std::atomic<uint64_t> *subtreeNodes = nullptr) {
+            nodeCount++;
+            if (subtreeNodes) {
+                subtreeNodes->fetch_add(1, std::memory_order_relaxed);
+            }
             std::array<Move, maxDepth> bestLine;
             int bestScore = -50000;
+            //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+            if (ply > 0) {
+                alpha = std::max(alpha, -mateScore + ply);
+                beta = std::min(beta, mateScore - ply - 1);
+                if (alpha >= beta) {
+                    return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                }
+            }
             // create move list for player
             const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
              //check for mate
             if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
-                return std::make_pair(std::array<Move, maxDepth>(), -mateScore-depth);
+                return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
+            }
+            //stalemate
+            else if (moveList.Count() == 0){
+                return std::make_pair(std::array<Move, maxDepth>(), 0);
+            }
+            if (depth == 0) {
+                int score = evaluation.eval(chessBoard);
+                if (color == Black) {
+                    score *= -1;
+                }
+                return std::make_pair(std::array<Move, maxDepth>(), score);
+            }
+
+            constexpr enum Color Ocolor = Opposite(color);
+            //at the root the caller may hand in the moves already ordered, their subtree sizes are recorded for the next iteration
+            const uint8_t moveCount = rootMoves ? rootMoves->size() : moveList.Count();
+            auto moveAt = [&](uint8_t i) {
+                return rootMoves ? (*rootMoves)[i].move : moveList[i];
+            };
+            //the tasks of a root subtree run on any thread, so every node below a root move counts itself into the move's counter
+            std::vector<std::atomic<uint64_t>> rootNodes(rootMoves ? moveCount : 0);
+            auto nodesOf = [&](uint8_t i) {
+                return rootMoves ? &rootNodes[i] : subtreeNodes;
+            };
+
+            // Process the leftmost child sequentially, at a CUT node the next few as well
+            const uint8_t serial = serialMoves(type, moveCount);
+            for (uint8_t i = 0; i < serial; i++) {
+                Move nextMove = moveAt(i);
+                Square from = nextMove.From();
+                Square to = nextMove.To();
+                Piece promotion = nextMove.Promotion();
+                //create local copy for safety
+                StockDory::Board boardCopy = chessBoard;
+                PreviousState prevState = boardCopy.Move<0>(from, to, promotion);
+                std::pair<std::array<Move, maxDepth>, int> result = YBWCSearch<Ocolor, maxDepth>(boardCopy, -beta, -alpha, depth - 1, ply + 1, nullptr, childType(type, i), nodesOf(i));
+                if (rootMoves) {
+                    (*rootMoves)[i].nodes = rootNodes[i].load(std::memory_order_relaxed);
+                }
+                result.second = -result.second;
+                boardCopy.UndoMove<0>(prevState, from, to);
+                if (result.second > bestScore) {
+                    bestScore = result.second;
+                    bestLine[0] = nextMove;
+                    //Store best line
+                    for (int j = 0; j < depth - 1; j++) {
+                        bestLine[j + 1] = result.first[j];
+                    }
+                    alpha = std::max(alpha, bestScore);
+                }
+                //Cutoff
+                if (alpha >= beta) {
+                    return std::make_pair(bestLine, bestScore);
+                }
+            }
+            //none of the likely refutations worked -> the CUT prediction was wrong, the rest is searched like an ALL node
+            if (type == CutNode) {
+                type = AllNode;
+            }
+            //one task per move, near the leaves they are run on the spot since handing them out costs more than they take
+            for (uint8_t i = serial; i < moveCount; i++) {
+                #pragma omp task default(shared) firstprivate(i) if(depth > minSplitDepth)
+                {
+                    int bound;
+                    #pragma omp critical
+                    {
+                        bound = alpha;
+                    }
+                    //a brother may already have caused the cutoff
+                    if (bound < beta) {
+                        //Private copy of the board for each task
+                        StockDory::Board threadBoard = chessBoard;
+                        Move nextMove = moveAt(i);
+                        Square from = nextMove.From();
+                        Square to = nextMove.To();
+                        Piece promotion = nextMove.Promotion();
+                        PreviousState prevState = threadBoard.Move<0>(from, to, promotion);
+                        //the search waits for the tasks it opened before returning, so the counter holds the whole subtree
+                        std::pair<std::array<Move, maxDepth>, int> localResult = YBWCSearch<Ocolor, maxDepth>(threadBoard, -beta, -bound, depth - 1, ply + 1, nullptr, childType(type, i), nodesOf(i));
+                        if (rootMoves) {
+                            (*rootMoves)[i].nodes = rootNodes[i].load(std::memory_order_relaxed);
+                        }
+                        localResult.second = -localResult.second;
+                        threadBoard.UndoMove<0>(prevState, from, to);
+                        #pragma omp critical
+                        {
+                            if (localResult.second > bestScore) {
+                                bestScore = localResult.second;
+                                bestLine[0] = nextMove;
+                                for (int j = 0; j < depth - 1; j++) {
+                                    bestLine[j + 1] = localResult.first[j];
+                                }
+                                alpha = std::max(alpha, bestScore);
+                            }
+                        }
+                    }
+                }
+            }
+            //the master helps out here until every move of this split point is done
+            #pragma omp taskwait
+
+            return std::make_pair(bestLine, bestScore);
+        }
+
+        //YBWC on the work-stealing scheduler -> the moves of a split point go to the deque of the thread that opened it and
+        //idle threads steal the oldest ones. Unlike a parallel for per node, work from every ply of the tree sits in the
+        //same deques, so a thread that finishes early takes over the biggest open subtree wherever it is.
+        template<Color color, int maxDepth>
+        std::pair<std::array<Move, maxDepth>, int> stealingYBWC(const StockDory::Board &chessBoard, int alpha, int beta, int depth, const WorkStealingScheduler::Config &config = {}) {
+            WorkStealingScheduler scheduler(config);
+            std::pair<std::array<Move, maxDepth>, int> result;
+            scheduler.run([&] {
+                result = stealingYBWCSearch<color, maxDepth>(scheduler, chessBoard, alpha, beta, depth, 0, PVNode);
+            });
+            return result;
+        }
+
+        template<Color color, int maxDepth>
+        std::pair<std::array<Move, maxDepth>, int> stealingYBWCSearch(WorkStealingScheduler &scheduler, const StockDory::Board &chessBoard, int alpha, int beta, int depth, int ply, NodeType type) {
+            std::array<Move, maxDepth> bestLine;
+            int bestScore = -50000;
+            //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+            if (ply > 0) {
+                alpha = std::max(alpha, -mateScore + ply);
+                beta = std::min(beta, mateScore - ply - 1);
+                if (alpha >= beta) {
+                    return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                }
+            }
+            // create move list for player
+            const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
+             //check for mate
+            if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
+                return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
+            }
+            //stalemate
+            else if (moveList.Count() == 0){
+                return std::make_pair(std::array<Move, maxDepth>(), 0);
+            }
+            if (depth == 0) {
+                int score = evaluation.eval(chessBoard);
+                if (color == Black) {
+                    score *= -1;
+                }
+                return std::make_pair(std::array<Move, maxDepth>(), score);
+            }
+
+            constexpr enum Color Ocolor = Opposite(color);
+            //one lock per split point, the children of different nodes never wait for each other
+            std::mutex lock;
+            //searches one child with the best bound known when it starts
+            auto searchMove = [&](uint8_t i, NodeType childNode) {
+                int bound;
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    bound = alpha;
+                }
+                //a brother may already have caused the cutoff
+                if (bound >= beta) {
+                    return;
+                }
+                //Private copy of the board for each task
+                StockDory::Board threadBoard = chessBoard;
+                Move nextMove = moveList[i];
+                threadBoard.Move<0>(nextMove.From(), nextMove.To(), nextMove.Promotion());
+                std::pair<std::array<Move, maxDepth>, int> result = stealingYBWCSearch<Ocolor, maxDepth>(scheduler, threadBoard, -beta, -bound, depth - 1, ply + 1, childNode);
+                result.second = -result.second;
+                std::lock_guard<std::mutex> guard(lock);
+                if (result.second > bestScore) {
+                    bestScore = result.second;
+                    bestLine[0] = nextMove;
+                    for (int j = 0; j < depth - 1; j++) {
+                        bestLine[j + 1] = result.first[j];
+                    }
+                    alpha = std::max(alpha, bestScore);
+                }
+            };
+
+            // Process the leftmost child sequentially, at a CUT node the next few as well
+            const uint8_t serial = serialMoves(type, moveList.Count());
+            for (uint8_t i = 0; i < serial; i++) {
+                searchMove(i, childType(type, i));
+                //Cutoff
+                if (alpha >= beta) {
+                    return std::make_pair(bestLine, bestScore);
+                }
+            }
+            if (type == CutNode) {
+                type = AllNode;
+            }
+            //the rest goes to this thread's deque, near the leaves it is cheaper to search it here
+            TaskGroup group;
+            for (uint8_t i = serial; i < moveList.Count(); i++) {
+                if (depth <= minSplitDepth) {
+                    searchMove(i, childType(type, i));
+                }
+                else {
+                    scheduler.spawn(group, [&searchMove, i, childNode = childType(type, i)] {
+                        searchMove(i, childNode);
+                    });
+                }
+            }
+            scheduler.wait(group);
+
+            return std::make_pair(bestLine, bestScore);
+        }
+
+        //YBWC on the persistent thread team -> every split point, at any depth, hands its moves to the members that are
+        //idle at that moment. Nothing is created or woken per split, members that just finished are still spinning.
+        template<Color color, int maxDepth>
+        std::pair<std::array<Move, maxDepth>, int> teamYBWC(const StockDory::Board &chessBoard, int alpha, int beta, int depth) {
+            ThreadTeam &team = ThreadTeam::shared();
+            team.resize(omp_get_max_threads());
+            return teamYBWCSearch<color, maxDepth>(team, chessBoard, alpha, beta, depth, 0, PVNode);
+        }
+
+        template<Color color, int maxDepth>
+        std::pair<std::array<Move, maxDepth>, int> teamYBWCSearch(ThreadTeam &team, const StockDory::Board &chessBoard, int alpha, int beta, int depth, int ply, NodeType type) {
+            std::array<Move, maxDepth> bestLine;
+            int bestScore = -50000;
+            //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+            if (ply > 0) {
+                alpha = std::max(alpha, -mateScore + ply);
+                beta = std::min(beta, mateScore - ply - 1);
+                if (alpha >= beta) {
+                    return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                }
+            }
+            // create move list for player
+            const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
+             //check for mate
+            if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
+                return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
+            }
+            //stalemate
+            else if (moveList.Count() == 0){
+                return std::make_pair(std::array<Move, maxDepth>(), 0);
+            }
+            if (depth == 0) {
+                int score = evaluation.eval(chessBoard);
+                if (color == Black) {
+                    score *= -1;
+                }
+                return std::make_pair(std::array<Move, maxDepth>(), score);
+            }
+
+            constexpr enum Color Ocolor = Opposite(color);
+            std::mutex lock;
+            //searches one child with the best bound known when it starts
+            auto searchMove = [&](int i, NodeType childNode) {
+                int bound;
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    bound = alpha;
+                }
+                //a brother may already have caused the cutoff
+                if (bound >= beta) {
+                    return;
+                }
+                //Private copy of the board for each thread
+                StockDory::Board threadBoard = chessBoard;
+                Move nextMove = moveList[i];
+                threadBoard.Move<0>(nextMove.From(), nextMove.To(), nextMove.Promotion());
+                std::pair<std::array<Move, maxDepth>, int> result = teamYBWCSearch<Ocolor, maxDepth>(team, threadBoard, -beta, -bound, depth - 1, ply + 1, childNode);
+                result.second = -result.second;
+                std::lock_guard<std::mutex> guard(lock);
+                if (result.second > bestScore) {
+                    bestScore = result.second;
+                    bestLine[0] = nextMove;
+                    for (int j = 0; j < depth - 1; j++) {
+                        bestLine[j + 1] = result.first[j];
+                    }
+                    alpha = std::max(alpha, bestScore);
+                }
+            };
+
+            // Process the leftmost child sequentially, at a CUT node the next few as well
+            const uint8_t serial = serialMoves(type, moveList.Count());
+            for (uint8_t i = 0; i < serial; i++) {
+                searchMove(i, childType(type, i));
+                //Cutoff
+                if (alpha >= beta) {
+                    return std::make_pair(bestLine, bestScore);
+                }
+            }
+            if (type == CutNode) {
+                type = AllNode;
+            }
+            if (depth <= minSplitDepth) {
+                for (uint8_t i = serial; i < moveList.Count(); i++) {
+                    searchMove(i, childType(type, i));
+                }
+            }
+            else {
+                team.parallelFor(moveList.Count() - serial, [&](int i) {
+                    searchMove(serial + i, childType(type, serial + i));
+                });
+            }
+
+            return std::make_pair(bestLine, bestScore);
+        }
+
+        template<Color color, int maxDepth>
+        std::pair<std::array<Move, maxDepth>, int> PVS(const StockDory::Board &chessBoard, int alpha, int beta, int depth, int ply = 0) {
+            std::array<Move, maxDepth> bestLine;
+            int bestScore = -50000;
+            //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+            if (ply > 0) {
+                alpha = std::max(alpha, -mateScore + ply);
+                beta = std::min(beta, mateScore - ply - 1);
+                if (alpha >= beta) {
+                    return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                }
+            }
+            // create move list for player
+            const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
+             //check for mate
+            if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
+                return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
             }
             //stalemate
             else if (moveList.Count() == 0){
@@ -659,7 +1529,7 @@ class Engine {
             //create local copy for safety
             StockDory::Board boardCopy = chessBoard;
             PreviousState prevState = boardCopy.Move<0>(from, to, promotion);
-            std::pair<std::array<Move, maxDepth>, int> result = YBWC<Ocolor, maxDepth>(boardCopy, -beta, -alpha, depth - 1);
+            std::pair<std::array<Move, maxDepth>, int> result = PVS<Ocolor, maxDepth>(boardCopy, -beta, -alpha, depth - 1, ply + 1);
             result.second = -result.second;
             boardCopy.UndoMove<0>(prevState, from, to);
             if (result.second > bestScore) {
@@ -691,7 +1561,7 @@ class Engine {
                 Square to = nextMove.To();
                 Piece promotion = nextMove.Promotion();
                 PreviousState prevState = threadBoard.Move<0>(from, to, promotion);
-                std::pair<std::array<Move, maxDepth>, int> localResult = YBWC<Ocolor, maxDepth>(threadBoard, -beta, -alpha, depth - 1);
+                std::pair<std::array<Move, maxDepth>, int> localResult = alphaBetaNegaParallel<Ocolor, maxDepth>(threadBoard, -beta, -alpha, depth - 1, ply + 1, CutNode);
                 localResult.second = -localResult.second;
                 threadBoard.UndoMove<0>(prevState, from, to);
                 #pragma omp critical
@@ -710,15 +1580,168 @@ class Engine {
             return std::make_pair(bestLine, bestScore);
         }
 
+        //PV-Split: walk down the principal variation of the previous iteration one node at a time, then on the way back up
+        //search the siblings of each PV node in parallel with the bound the PV proved, each with a sequential alpha-beta
         template<Color color, int maxDepth>
-        std::pair<std::array<Move, maxDepth>, int> PVS(const StockDory::Board &chessBoard, int alpha, int beta, int depth) {
+        std::pair<std::array<Move, maxDepth>, int> pvSplit(const StockDory::Board &chessBoard, int alpha, int beta, int depth, const std::array<Move, maxDepth> &pv, int ply = 0) {
+            //too little work left below to pay for a split
+            if (depth <= 2) {
+                StockDory::Board boardCopy = chessBoard;
+                return alphaBetaNega<color, maxDepth>(boardCopy, alpha, beta, depth, ply);
+            }
             std::array<Move, maxDepth> bestLine;
             int bestScore = -50000;
+            //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+            if (ply > 0) {
+                alpha = std::max(alpha, -mateScore + ply);
+                beta = std::min(beta, mateScore - ply - 1);
+                if (alpha >= beta) {
+                    return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                }
+            }
             // create move list for player
             const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
              //check for mate
             if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
-                return std::make_pair(std::array<Move, maxDepth>(), -mateScore-depth);
+                return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
+            }
+            //stalemate
+            else if (moveList.Count() == 0){
+                return std::make_pair(std::array<Move, maxDepth>(), 0);
+            }
+
+            constexpr enum Color Ocolor = Opposite(color);
+
+            //the PV move goes first, the first generated move when the old line does not reach this far
+            uint8_t pvIndex = 0;
+            for (uint8_t i = 0; i < moveList.Count(); i++) {
+                if (moveList[i] == pv[ply]) {
+                    pvIndex = i;
+                    break;
+                }
+            }
+            Move PV = moveList[pvIndex];
+            StockDory::Board boardCopy = chessBoard;
+            boardCopy.Move<0>(PV.From(), PV.To(), PV.Promotion());
+            std::pair<std::array<Move, maxDepth>, int> result = pvSplit<Ocolor, maxDepth>(boardCopy, -beta, -alpha, depth - 1, pv, ply + 1);
+            result.second = -result.second;
+            bestScore = result.second;
+            bestLine[0] = PV;
+            //Store best line
+            for (int j = 0; j < depth - 1; j++) {
+                bestLine[j + 1] = result.first[j];
+            }
+            alpha = std::max(alpha, bestScore);
+            //Cutoff
+            if (alpha >= beta) {
+                return std::make_pair(bestLine, bestScore);
+            }
+            //Siblings of the PV node, each one a plain sequential search
+            #pragma omp parallel for shared(alpha, beta) schedule(dynamic)
+            for (uint8_t i = 0; i < moveList.Count(); i++) {
+                int bound;
+                #pragma omp critical
+                {
+                    bound = alpha;
+                }
+                if (i == pvIndex or bound >= beta) {
+                    continue; // Mimic cutoff because you cannot break in
+                }
+                //Private copy of the board for each thread
+                StockDory::Board threadBoard = chessBoard;
+                Move nextMove = moveList[i];
+                threadBoard.Move<0>(nextMove.From(), nextMove.To(), nextMove.Promotion());
+                std::pair<std::array<Move, maxDepth>, int> localResult = alphaBetaNega<Ocolor, maxDepth>(threadBoard, -beta, -bound, depth - 1, ply + 1);
+                localResult.second = -localResult.second;
+                #pragma omp critical
+                {
+                    if (localResult.second > bestScore) {
+                        bestScore = localResult.second;
+                        bestLine[0] = nextMove;
+                        for (int j = 0; j < depth - 1; j++) {
+                            bestLine[j + 1] = localResult.first[j];
+                        }
+                        alpha = std::max(alpha, bestScore);
+                    }
+                }
+            }
+
+            return std::make_pair(bestLine, bestScore);
+        }
+
+        //iterative deepening driver for PV-Split -> every iteration splits along the line the previous one found
+        template<Color color, int maxDepth>
+        std::pair<std::array<Move, maxDepth>, int> iterativePVSplit(const StockDory::Board &chessBoard, int depth) {
+            std::pair<std::array<Move, maxDepth>, int> result;
+            for (int d = 1; d <= depth; d++) {
+                result = pvSplit<color, maxDepth>(chessBoard, -50000, 50000, d, result.first);
+            }
+            return result;
+        }
+
+        //root moves in generation order, before any iteration has measured them
+        template<Color color>
+        static std::vector<RootMove> rootMoveList(const StockDory::Board &chessBoard) {
+            const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
+            std::vector<RootMove> rootMoves(moveList.Count());
+            for (uint8_t i = 0; i < moveList.Count(); i++) {
+                rootMoves[i].move = moveList[i];
+            }
+            return rootMoves;
+        }
+
+        //best move of the last iteration first, then the biggest subtrees -> with a dynamic schedule those are handed out
+        //first, and the small ones fill in the gaps at the end instead of one thread finishing a big one alone
+        static void orderRootMoves(std::vector<RootMove> &rootMoves, Move best) {
+            std::stable_sort(rootMoves.begin(), rootMoves.end(), [best](const RootMove &a, const RootMove &b) {
+                if (a.move == best or b.move == best) {
+                    return a.move == best and not (b.move == best);
+                }
+                return a.nodes > b.nodes;
+            });
+        }
+
+        template<Color color, int maxDepth>
+        std::pair<std::array<Move, maxDepth>, int> iterativeNaiveParallelAlphaBeta(const StockDory::Board &chessBoard, int depth) {
+            std::vector<RootMove> rootMoves = rootMoveList<color>(chessBoard);
+            std::pair<std::array<Move, maxDepth>, int> result;
+            for (int d = 1; d <= depth; d++) {
+                result = naiveParallelAlphaBeta<color, maxDepth>(chessBoard, -50000, 50000, d, 0, &rootMoves);
+                orderRootMoves(rootMoves, result.first[0]);
+            }
+            return result;
+        }
+
+        template<Color color, int maxDepth>
+        std::pair<std::array<Move, maxDepth>, int> iterativeYBWC(const StockDory::Board &chessBoard, int depth) {
+            std::vector<RootMove> rootMoves = rootMoveList<color>(chessBoard);
+            std::pair<std::array<Move, maxDepth>, int> result;
+            for (int d = 1; d <= depth; d++) {
+                result = YBWC<color, maxDepth>(chessBoard, -50000, 50000, d, 0, &rootMoves);
+                orderRootMoves(rootMoves, result.first[0]);
+            }
+            return result;
+        }
+
+        //Jamboree (parallel scout): the first child sets the bound, the rest only have to prove they cannot beat it.
+        //All of them are tested with a zero window in parallel and only the ones that fail high are searched again.
+        template<Color color, int maxDepth>
+        std::pair<std::array<Move, maxDepth>, int> jamboree(const StockDory::Board &chessBoard, int alpha, int beta, int depth, int ply = 0, NodeType type = PVNode) {
+            std::array<Move, maxDepth> bestLine;
+            int bestScore = -50000;
+            //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+            if (ply > 0) {
+                alpha = std::max(alpha, -mateScore + ply);
+                beta = std::min(beta, mateScore - ply - 1);
+                if (alpha >= beta) {
+                    return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                }
+            }
+            // create move list for player
+            const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
+             //check for mate
+            if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
+                return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
             }
             //stalemate
             else if (moveList.Count() == 0){
@@ -734,37 +1757,46 @@ class Engine {
 
             constexpr enum Color Ocolor = Opposite(color);
 
-            // Process the leftmost child sequentially
-            Move PV = moveList[0];
-            Square from = PV.From();
-            Square to = PV.To();
-            Piece promotion = PV.Promotion();
-            //create local copy for safety
-            StockDory::Board boardCopy = chessBoard;
-            PreviousState prevState = boardCopy.Move<0>(from, to, promotion);
-            std::pair<std::array<Move, maxDepth>, int> result = PVS<Ocolor, maxDepth>(boardCopy, -beta, -alpha, depth - 1);
-            result.second = -result.second;
-            boardCopy.UndoMove<0>(prevState, from, to);
-            if (result.second > bestScore) {
-                bestScore = result.second;
-                bestLine[0] = PV;
-                //Store best line
-                for (int j = 0; j < depth - 1; j++) {
-                    bestLine[j + 1] = result.first[j];
+            // Process the leftmost child sequentially with the full window, at a CUT node the next few as well
+            const uint8_t serial = serialMoves(type, moveList.Count());
+            for (uint8_t i = 0; i < serial; i++) {
+                Move nextMove = moveList[i];
+                Square from = nextMove.From();
+                Square to = nextMove.To();
+                Piece promotion = nextMove.Promotion();
+                //create local copy for safety
+                StockDory::Board boardCopy = chessBoard;
+                PreviousState prevState = boardCopy.Move<0>(from, to, promotion);
+                std::pair<std::array<Move, maxDepth>, int> result = jamboree<Ocolor, maxDepth>(boardCopy, -beta, -alpha, depth - 1, ply + 1, childType(type, i));
+                result.second = -result.second;
+                boardCopy.UndoMove<0>(prevState, from, to);
+                if (result.second > bestScore) {
+                    bestScore = result.second;
+                    bestLine[0] = nextMove;
+                    //Store best line
+                    for (int j = 0; j < depth - 1; j++) {
+                        bestLine[j + 1] = result.first[j];
+                    }
+                    alpha = std::max(alpha, bestScore);
+                }
+                //Cutoff
+                if (alpha >= beta) {
+                    return std::make_pair(bestLine, bestScore);
                 }
-                alpha = std::max(alpha, bestScore);
             }
-            //Cutoff
-            if (alpha >= beta) {
-                return std::make_pair(bestLine, bestScore);
+            //none of the likely refutations worked -> the CUT prediction was wrong, the rest is tested like an ALL node
+            if (type == CutNode) {
+                type = AllNode;
             }
             //Dynamic schedule since we do not know the ordering of moves or the number of moves in each call
             #pragma omp parallel for shared(alpha, beta) schedule(dynamic)
-            for (uint8_t i = 1; i < moveList.Count(); i++) {
-                // int thread = omp_get_thread_num();
-                // // printf("%d\n", thread);
-                // printf("I hit the for loop for thread %d \n", thread);
-                if (alpha >= beta) {
+            for (uint8_t i = serial; i < moveList.Count(); i++) {
+                int bound;
+                #pragma omp critical
+                {
+                    bound = alpha;
+                }
+                if (bound >= beta) {
                     continue; // Mimic cutoff because you cannot break in
                 }
                 //Private copy of the board for each thread
@@ -773,10 +1805,16 @@ class Engine {
                 Square from = nextMove.From();
                 Square to = nextMove.To();
                 Piece promotion = nextMove.Promotion();
-                PreviousState prevState = threadBoard.Move<0>(from, to, promotion);
-                std::pair<std::array<Move, maxDepth>, int> localResult = alphaBetaNegaParallel<Ocolor, maxDepth>(threadBoard, -beta, -alpha, depth - 1);
+                threadBoard.Move<0>(from, to, promotion);
+                //zero window test -> can this move do better than the bound at all?
+                std::pair<std::array<Move, maxDepth>, int> localResult = jamboree<Ocolor, maxDepth>(threadBoard, -bound - 1, -bound, depth - 1, ply + 1, childType(type, i));
                 localResult.second = -localResult.second;
-                threadBoard.UndoMove<0>(prevState, from, to);
+                //fail high inside the window -> the test only gave a lower bound, search again for the real score
+                if (localResult.second > bound and localResult.second < beta) {
+                    //the move beat the best one so far, it is the new principal variation
+                    localResult = jamboree<Ocolor, maxDepth>(threadBoard, -beta, -bound, depth - 1, ply + 1, PVNode);
+                    localResult.second = -localResult.second;
+                }
                 #pragma omp critical
                 {
                     if (localResult.second > bestScore) {
@@ -794,14 +1832,22 @@ class Engine {
         }
 
         template<Color color, int maxDepth>
-        std::pair<std::array<Move, maxDepth>, int> alphaBetaNegaParallel(const StockDory::Board &chessBoard, int alpha, int beta, int depth) {
+        std::pair<std::array<Move, maxDepth>, int> alphaBetaNegaParallel(const StockDory::Board &chessBoard, int alpha, int beta, int depth, int ply = 0, NodeType type = AllNode) {
             std::array<Move, maxDepth> bestLine;
             int bestScore = -50000;
+            //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+            if (ply > 0) {
+                alpha = std::max(alpha, -mateScore + ply);
+                beta = std::min(beta, mateScore - ply - 1);
+                if (alpha >= beta) {
+                    return std::make_pair(std::array<Move, maxDepth>(), alpha);
+                }
+            }
             // create move list for player
             const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
              //check for mate
             if (moveList.Count() == 0 and chessBoard.Checked<color>()) {
-                return std::make_pair(std::array<Move, maxDepth>(), -mateScore-depth);
+                return std::make_pair(std::array<Move, maxDepth>(), -mateScore+ply);
             }
             //stalemate
             else if (moveList.Count() == 0){
@@ -816,9 +1862,37 @@ class Engine {
             }
 
             constexpr enum Color Ocolor = Opposite(color);
+            //a predicted CUT node tries its likely refutations one at a time before it splits
+            const uint8_t serial = type == CutNode ? serialMoves(type, moveList.Count()) : 0;
+            for (uint8_t i = 0; i < serial; i++) {
+                StockDory::Board boardCopy = chessBoard;
+                Move nextMove = moveList[i];
+                Square from = nextMove.From();
+                Square to = nextMove.To();
+                Piece promotion = nextMove.Promotion();
+                PreviousState prevState = boardCopy.Move<0>(from, to, promotion);
+                std::pair<std::array<Move, maxDepth>, int> result = alphaBetaNegaParallel<Ocolor, maxDepth>(boardCopy, -beta, -alpha, depth - 1, ply + 1, childType(type, i));
+                result.second = -result.second;
+                boardCopy.UndoMove<0>(prevState, from, to);
+                if (result.second > bestScore) {
+                    bestScore = result.second;
+                    bestLine[0] = nextMove;
+                    for (int j = 0; j < depth - 1; j++) {
+                        bestLine[j + 1] = result.first[j];
+                    }
+                    alpha = std::max(alpha, bestScore);
+                }
+                //Cutoff
+                if (alpha >= beta) {
+                    return std::make_pair(bestLine, bestScore);
+                }
+            }
+            if (type == CutNode) {
+                type = AllNode;
+            }
             //Dynamic schedule since we do not know the ordering of moves or the number of moves in each call
             #pragma omp parallel for shared(alpha, beta) schedule(dynamic)
-            for (uint8_t i = 0; i < moveList.Count(); i++) {
+            for (uint8_t i = serial; i < moveList.Count(); i++) {
                 // int thread = omp_get_thread_num();
                 // // printf("%d\n", thread);
                 // printf("I hit the for loop for thread %d \n", thread);
@@ -832,7 +1906,7 @@ class Engine {
                 Square to = nextMove.To();
                 Piece promotion = nextMove.Promotion();
                 PreviousState prevState = threadBoard.Move<0>(from, to, promotion);
-                std::pair<std::array<Move, maxDepth>, int> localResult = alphaBetaNegaParallel<Ocolor, maxDepth>(threadBoard, -beta, -alpha, depth - 1);
+                std::pair<std::array<Move, maxDepth>, int> localResult = alphaBetaNegaParallel<Ocolor, maxDepth>(threadBoard, -beta, -alpha, depth - 1, ply + 1, childType(type, i));
                 localResult.second = -localResult.second;
                 threadBoard.UndoMove<0>(prevState, from, to);
                 #pragma omp critical
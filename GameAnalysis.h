@@ -0,0 +1,126 @@
+//
+// Game analysis: searches every position of a game, from the last move back to the first, on one transposition table.
+// Consecutive positions share most of their trees, so each earlier search finds exact entries and best moves left by
+// the later ones. The played move is a root child of its position's last iteration, so the best move and the played
+// move are scored by one search with one horizon.
+//
+
+#ifndef GAMEANALYSIS_H
+#define GAMEANALYSIS_H
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "Engine.h"
+
+template<int maxDepth>
+class GameAnalysis {
+    private:
+        Engine engine;
+        //kept for the whole game
+        NumaTranspositionTable<SearchEntry> transpositionTable{16 * 1024 * 1024};
+
+        template<Color color>
+        static bool legal(const StockDory::Board &board, Move move) {
+            const StockDory::SimplifiedMoveList<color> moveList(board);
+            for (uint8_t i = 0; i < moveList.Count(); i++) {
+                if (moveList[i] == move) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //iterative deepening whose last iteration searches the played move first with the full window, its exact score
+        //is then the bound the other root moves have to beat
+        template<Color color>
+        std::pair<std::array<Move, maxDepth>, int> searchPlayed(StockDory::Board &board, Move played, int depth, int &playedScore) {
+            for (int d = 1; d < depth; d++) {
+                engine.alphaBetaNegaTT<color, maxDepth>(transpositionTable, board, -50000, 50000, d);
+            }
+            constexpr enum Color Ocolor = Opposite(color);
+            std::array<Move, maxDepth> bestLine;
+            int bestScore = -50000;
+            auto searchMove = [&](Move move, int alpha) {
+                PreviousState prevState = board.Move<ZOBRIST>(move.From(), move.To(), move.Promotion());
+                std::pair<std::array<Move, maxDepth>, int> result =
+                        engine.alphaBetaNegaTT<Ocolor, maxDepth>(transpositionTable, board, -50000, -alpha, depth - 1, 1);
+                board.UndoMove<ZOBRIST>(prevState, move.From(), move.To());
+                result.second = -result.second;
+                if (result.second > bestScore) {
+                    bestScore = result.second;
+                    bestLine[0] = move;
+                    for (int j = 0; j < depth - 1; j++) {
+                        bestLine[j + 1] = result.first[j];
+                    }
+                }
+                return result.second;
+            };
+            playedScore = searchMove(played, -50000);
+            const StockDory::SimplifiedMoveList<color> moveList(board);
+            for (uint8_t i = 0; i < moveList.Count(); i++) {
+                if (not (moveList[i] == played)) {
+                    searchMove(moveList[i], bestScore);
+                }
+            }
+            //exact, the search of the position before this one finds it as a child
+            const ZobristHash hash = board.Zobrist();
+            transpositionTable[hash].Store(hash, bestLine[0], engine.scoreToTT(bestScore, 0), depth, ExactBound);
+            engine.extendLineTT<color, maxDepth>(transpositionTable, board, bestLine, 0, depth);
+            return std::make_pair(bestLine, bestScore);
+        }
+
+    public:
+        struct Result {
+            std::string fen;
+            Move played;
+            //best line and score of the position before the move, from the side to move's point of view
+            std::array<Move, maxDepth> bestLine;
+            int bestScore;
+            //what the played move is worth from the same point of view, as a child of the same search
+            int playedScore;
+        };
+
+        //moves are in coordinate notation (e2e4, e7e8q), one result per move, in game order
+        std::vector<Result> analyze(const std::string &startFen, const std::vector<std::string> &moves, int depth) {
+            std::vector<StockDory::Board> positions;
+            std::vector<Move> played;
+            positions.emplace_back(startFen);
+            for (const std::string &text : moves) {
+                Move move = Move::FromString(text);
+                StockDory::Board next = positions.back();
+                bool isLegal = next.ColorToMove() == White ? legal<White>(next, move) : legal<Black>(next, move);
+                if (not isLegal) {
+                    throw std::invalid_argument("Illegal move " + text + " in position " + next.Fen());
+                }
+                next.Move<ZOBRIST>(move.From(), move.To(), move.Promotion());
+                positions.push_back(next);
+                played.push_back(move);
+            }
+
+            //walk backwards, the final position first. It has no move to score but leaves its entries for the others.
+            std::vector<std::pair<std::array<Move, maxDepth>, int>> searched(positions.size());
+            std::vector<int> playedScores(played.size());
+            for (size_t i = positions.size(); i-- > 0;) {
+                StockDory::Board &board = positions[i];
+                if (i == played.size()) {
+                    searched[i] = board.ColorToMove() == White ?
+                            engine.iterativeDeepeningTT<White, maxDepth>(transpositionTable, board, depth) :
+                            engine.iterativeDeepeningTT<Black, maxDepth>(transpositionTable, board, depth);
+                    continue;
+                }
+                searched[i] = board.ColorToMove() == White ?
+                        searchPlayed<White>(board, played[i], depth, playedScores[i]) :
+                        searchPlayed<Black>(board, played[i], depth, playedScores[i]);
+            }
+
+            std::vector<Result> results;
+            for (size_t i = 0; i < played.size(); i++) {
+                results.push_back({positions[i].Fen(), played[i], searched[i].first, searched[i].second, playedScores[i]});
+            }
+            return results;
+        }
+};
+
+#endif //GAMEANALYSIS_H
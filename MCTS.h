@@ -0,0 +1,211 @@
+//
+// Monte Carlo Tree Search with tree parallelization: all threads walk and grow one shared tree.
+// Nodes come from a preallocated pool and every field a thread can race on is atomic, so there are no locks.
+// A thread walking down adds a virtual loss to every node it passes, which steers the others to different lines.
+//
+
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <atomic>
+#include <cmath>
+#include <vector>
+#include <omp.h>
+
+#include "Engine.h"
+
+template<int maxDepth>
+class MCTS {
+    private:
+        struct Node {
+            Move move;
+            uint32_t parent = 0;
+            //index of the first child, the children of a node are next to each other in the pool
+            std::atomic<uint32_t> children{Unexpanded};
+            std::atomic<uint8_t> childCount{0};
+            std::atomic<int32_t> visits{0};
+            std::atomic<int32_t> virtualLoss{0};
+            //sum of the results, from the point of view of the side that played move
+            std::atomic<double> value{0.0};
+        };
+
+        static constexpr uint32_t Unexpanded = 0;
+        static constexpr uint32_t Expanding = UINT32_MAX;
+
+        Engine engine;
+        std::vector<Node> pool;
+        std::atomic<uint32_t> used{1};
+        //depth of the alpha-beta search that scores a new leaf, 0 is the plain evaluation
+        int playoutDepth;
+        //how much unexplored moves are favoured over good ones
+        double exploration = 1.4;
+
+        //centipawns to the chance of winning, mates come out as 0 and 1
+        static double winChance(int score) {
+            return 1.0 / (1.0 + std::pow(10.0, -score / 400.0));
+        }
+
+        static int centipawns(double chance) {
+            chance = std::clamp(chance, 0.0001, 0.9999);
+            return (int) std::lround(400.0 * std::log10(chance / (1.0 - chance)));
+        }
+
+        //upper confidence bound, a thread still below a child counts as a lost visit
+        uint32_t select(const Node &node) const {
+            uint32_t first = node.children.load(std::memory_order_acquire);
+            uint8_t count = node.childCount.load(std::memory_order_acquire);
+            double parentVisits = std::log((double) node.visits.load(std::memory_order_relaxed) +
+                                           node.virtualLoss.load(std::memory_order_relaxed) + 1);
+            uint32_t best = first;
+            double bestBound = -1;
+            for (uint32_t i = first; i < first + count; i++) {
+                const Node &child = pool[i];
+                int visits = child.visits.load(std::memory_order_relaxed);
+                int virtualLoss = child.virtualLoss.load(std::memory_order_relaxed);
+                if (visits + virtualLoss == 0) {
+                    return i;
+                }
+                double mean = child.value.load(std::memory_order_relaxed) / (visits + virtualLoss);
+                double bound = mean + exploration * std::sqrt(parentVisits / (visits + virtualLoss));
+                if (bound > bestBound) {
+                    bestBound = bound;
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+        //only the thread that wins the flag expands, the others score the node as a leaf this time
+        template<Color color>
+        bool expand(Node &node, const StockDory::Board &chessBoard) {
+            uint32_t expected = Unexpanded;
+            if (not node.children.compare_exchange_strong(expected, Expanding, std::memory_order_acquire)) {
+                return false;
+            }
+            const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
+            uint32_t first = used.fetch_add(moveList.Count(), std::memory_order_relaxed);
+            //pool is full -> the node stays a leaf for good
+            if (first + moveList.Count() > pool.size()) {
+                return false;
+            }
+            uint32_t self = &node - pool.data();
+            for (uint8_t i = 0; i < moveList.Count(); i++) {
+                reset(pool[first + i]);
+                pool[first + i].move = moveList[i];
+                pool[first + i].parent = self;
+            }
+            node.childCount.store(moveList.Count(), std::memory_order_relaxed);
+            node.children.store(first, std::memory_order_release);
+            return true;
+        }
+
+        static void reset(Node &node) {
+            node.children.store(Unexpanded, std::memory_order_relaxed);
+            node.childCount.store(0, std::memory_order_relaxed);
+            node.visits.store(0, std::memory_order_relaxed);
+            node.virtualLoss.store(0, std::memory_order_relaxed);
+            node.value.store(0.0, std::memory_order_relaxed);
+        }
+
+        template<Color color>
+        int playout(StockDory::Board &chessBoard, int ply) {
+            return engine.alphaBetaNega<color, maxDepth>(chessBoard, -50000, 50000, playoutDepth, ply).second;
+        }
+
+        //one walk from the root to a leaf and back
+        void iterate(const StockDory::Board &root) {
+            StockDory::Board board = root;
+            uint32_t current = 0;
+            int ply = 0;
+            pool[0].virtualLoss.fetch_add(1, std::memory_order_relaxed);
+            while (true) {
+                Node &node = pool[current];
+                uint32_t first = node.children.load(std::memory_order_acquire);
+                if (first == Unexpanded) {
+                    //a leaf is only worth children once it has been scored, the root always is
+                    bool ready = ply == 0 or node.visits.load(std::memory_order_relaxed) > 0;
+                    if (ready and ply < maxDepth - 1 and (board.ColorToMove() == White ? expand<White>(node, board) : expand<Black>(node, board))) {
+                        first = node.children.load(std::memory_order_acquire);
+                    }
+                    else {
+                        break;
+                    }
+                }
+                //another thread is still expanding it, or it is a position without moves
+                if (first == Expanding or node.childCount.load(std::memory_order_acquire) == 0) {
+                    break;
+                }
+                current = select(node);
+                Move nextMove = pool[current].move;
+                board.Move<0>(nextMove.From(), nextMove.To(), nextMove.Promotion());
+                pool[current].virtualLoss.fetch_add(1, std::memory_order_relaxed);
+                ply++;
+            }
+
+            //score of the leaf for its side to move, then for the side that moved into it
+            int score = board.ColorToMove() == White ? playout<White>(board, ply) : playout<Black>(board, ply);
+            double result = 1.0 - winChance(score);
+            while (true) {
+                Node &node = pool[current];
+                node.value.fetch_add(result, std::memory_order_relaxed);
+                node.visits.fetch_add(1, std::memory_order_relaxed);
+                node.virtualLoss.fetch_sub(1, std::memory_order_relaxed);
+                if (current == 0) {
+                    break;
+                }
+                current = node.parent;
+                result = 1.0 - result;
+            }
+        }
+
+    public:
+        explicit MCTS(size_t nodes = 1 << 20, int playoutDepth = 1) : pool(nodes), playoutDepth(playoutDepth) {}
+
+        //best line follows the most visited child, the score is the root's best move turned back into centipawns
+        std::pair<std::array<Move, maxDepth>, int> search(const StockDory::Board &chessBoard, int playouts) {
+            //children are reset when they are handed out, only the root has to be
+            reset(pool[0]);
+            used.store(1);
+
+            std::atomic<int> started{0};
+            #pragma omp parallel
+            {
+                while (started.fetch_add(1, std::memory_order_relaxed) < playouts) {
+                    iterate(chessBoard);
+                }
+            }
+
+            std::pair<std::array<Move, maxDepth>, int> result;
+            result.second = 0;
+            uint32_t current = 0;
+            for (int i = 0; i < maxDepth; i++) {
+                uint32_t first = pool[current].children.load(std::memory_order_acquire);
+                uint8_t count = pool[current].childCount.load(std::memory_order_acquire);
+                if (first == Unexpanded or first == Expanding or count == 0) {
+                    break;
+                }
+                uint32_t best = first;
+                for (uint32_t c = first; c < first + count; c++) {
+                    if (pool[c].visits.load() > pool[best].visits.load()) {
+                        best = c;
+                    }
+                }
+                if (pool[best].visits.load() == 0) {
+                    break;
+                }
+                if (i == 0) {
+                    result.second = centipawns(pool[best].value.load() / pool[best].visits.load());
+                }
+                result.first[i] = pool[best].move;
+                current = best;
+            }
+            return result;
+        }
+
+        //nodes taken from the pool by the last search
+        size_t size() const {
+            return std::min<size_t>(used.load(), pool.size());
+        }
+};
+
+#endif //MCTS_H
@@ -0,0 +1,33 @@
+//
+// Test positions of the drivers. main.cpp searches the mate in 3 suite, m4.cpp proves the mate in 4 suite, and the
+// batch analysis runs both when it is not given a FEN file.
+//
+
+#ifndef MATESUITES_H
+#define MATESUITES_H
+
+inline constexpr const char* mateIn3FENs[] = {
+    "7k/8/3NK3/5BN1/8/8/8/8 w - - 0 1",
+    "k7/3K4/3N4/2N5/8/3B4/8/8 w - - 0 1",
+    "8/8/2K5/7r/6r1/8/6k1/8 b - - 0 1",
+    "8/K7/7r/8/2k5/5bb1/8/8 b - - 0 1",
+    "8/K7/P6r/8/2k5/5bb1/8/8 b - - 0 1",
+    "8/8/8/8/k7/4Q3/3K4/8 w - - 0 1",
+    "8/8/k7/2K5/8/2Q5/b1R5/n7 w - - 0 1",
+    "8/8/k1K1b3/2n5/8/8/8/2R5 w - - 0 1",
+    "8/7P/k1K1b3/2n5/8/8/8/2R5 w - - 0 1",
+    "7k/7n/8/8/8/7B/7R/6RK w - - 0 1",
+};
+
+inline constexpr const char* mateIn4FENs[] = {
+    "8/8/5k2/R7/7R/8/8/5K2 w - - 0 1",
+    "8/8/5k2/7Q/R7/8/8/5K2 w - - 0 1",
+    "3k4/8/5K2/5R2/4B3/8/8/8 w - - 0 1",
+    "3k4/3N3P/8/3K4/8/8/8/8 w - - 0 1",
+    "8/8/8/3k4/1nnn1n2/8/8/2K5 b - - 1 1",
+    "8/8/8/2bk4/2bbb3/8/8/2K5 b - - 1 1",
+    "8/8/8/2nk4/2bbn3/8/8/2K5 b - - 1 1",
+    "8/8/8/8/8/1rkB4/3N1r2/3K4 b - - 1 1",
+};
+
+#endif //MATESUITES_H
@@ -0,0 +1,194 @@
+//
+// Staged move picker: hands out the moves of a position one at a time, in the order they are most likely to cause a
+// cutoff, and only generates a group of moves once the ones before it are used up.
+// Order: hash move, promotions and winning captures (MVV-LVA), killer moves, quiet moves, losing captures.
+//
+
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include <array>
+#include <cstdint>
+
+#include "Backend/Board.h"
+#include "Backend/Type/Move.h"
+#include "Backend/Type/Color.h"
+#include "SimplifiedMoveList.h"
+
+template<Color color>
+class MovePicker {
+    private:
+        enum Stage : uint8_t {
+            HashStage,
+            CaptureGeneration,
+            GoodCaptures,
+            KillerStage,
+            QuietGeneration,
+            QuietStage,
+            BadCaptures,
+            Done
+        };
+
+        //capture scores at or above this one do not lose material
+        static constexpr int Good = 1 << 10;
+
+        //the board has to be back in this position every time next is called
+        const StockDory::Board &board;
+        Stage stage = HashStage;
+        Move hashMove;
+        std::array<Move, 2> killers;
+        uint8_t killerIndex = 0;
+        //killers that were legal here and already handed out
+        uint8_t killersUsed = 0;
+
+        std::array<Move, 256> captures;
+        std::array<int, 256> scores;
+        uint8_t captureCount = 0;
+        uint8_t captureIndex = 0;
+
+        std::array<Move, 256> quiets;
+        uint8_t quietCount = 0;
+        uint8_t quietIndex = 0;
+
+        static constexpr int value(Piece piece) {
+            constexpr std::array<int, 7> values = {1, 3, 3, 5, 9, 20, 0};
+            return values[piece];
+        }
+
+        //moves that did not come from this position's generator have to be checked first
+        bool legal(Move move) const {
+            return board.IsPseudoLegal(move) and StockDory::IsLegal<color>(board, move);
+        }
+
+        bool handedOut(Move move) const {
+            if (stage > HashStage and move == hashMove) {
+                return true;
+            }
+            for (uint8_t i = 0; i < killersUsed; i++) {
+                if (move == killers[i]) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //most valuable victim first, among those the least valuable attacker. A promotion adds what the pawn turns into.
+        //Taking a piece worth at least the attacker, taking with the king (only possible when it is safe) or promoting
+        //does not lose material.
+        void generateCaptures() {
+            const StockDory::SimplifiedMoveList<color, StockDory::CaptureOnly> moveList(board);
+            for (uint8_t i = 0; i < moveList.Count(); i++) {
+                Move move = moveList[i];
+                Piece attacker = board[move.From()].Piece();
+                //en passant lands on an empty square, so does a promotion push, which takes nothing
+                bool enPassant = attacker == Pawn and move.To() == board.EnPassantSquare();
+                Piece victim = enPassant ? Pawn : board[move.To()].Piece();
+                int gain = move.Promotion() != NAP ? value(move.Promotion()) - value(Pawn) : 0;
+                int score = (value(victim) + gain) * 32 - value(attacker);
+                if (value(victim) >= value(attacker) or attacker == King or move.Promotion() != NAP) {
+                    score += Good;
+                }
+                captures[captureCount] = move;
+                scores[captureCount] = score;
+                captureCount++;
+            }
+        }
+
+        //selection sort one step at a time, most nodes only ever look at the first few captures
+        bool pickCapture(Move &move, bool good) {
+            while (captureIndex < captureCount) {
+                uint8_t best = captureIndex;
+                for (uint8_t i = captureIndex + 1; i < captureCount; i++) {
+                    if (scores[i] > scores[best]) {
+                        best = i;
+                    }
+                }
+                if (good and scores[best] < Good) {
+                    return false;
+                }
+                std::swap(captures[captureIndex], captures[best]);
+                std::swap(scores[captureIndex], scores[best]);
+                move = captures[captureIndex++];
+                if (not handedOut(move)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    public:
+        //hashMove and killers may be empty or belong to another position, they are only played when legal here
+        MovePicker(const StockDory::Board &chessBoard, Move hashMove, const std::array<Move, 2> &killers) :
+                board(chessBoard), hashMove(hashMove), killers(killers) {}
+
+        //false once every legal move has been handed out
+        bool next(Move &move) {
+            while (true) {
+                switch (stage) {
+                    case HashStage:
+                        stage = CaptureGeneration;
+                        if (legal(hashMove)) {
+                            move = hashMove;
+                            return true;
+                        }
+                        hashMove = Move();
+                        break;
+                    case CaptureGeneration:
+                        generateCaptures();
+                        stage = GoodCaptures;
+                        break;
+                    case GoodCaptures:
+                        if (pickCapture(move, true)) {
+                            return true;
+                        }
+                        stage = KillerStage;
+                        break;
+                    case KillerStage:
+                        while (killerIndex < killers.size()) {
+                            Move killer = killers[killerIndex++];
+                            if (not handedOut(killer) and quiet(killer) and legal(killer)) {
+                                killers[killersUsed++] = killer;
+                                move = killer;
+                                return true;
+                            }
+                        }
+                        stage = QuietGeneration;
+                        break;
+                    case QuietGeneration: {
+                        const StockDory::SimplifiedMoveList<color, StockDory::Quiets> moveList(board);
+                        for (uint8_t i = 0; i < moveList.Count(); i++) {
+                            quiets[quietCount++] = moveList[i];
+                        }
+                        stage = QuietStage;
+                        break;
+                    }
+                    case QuietStage:
+                        while (quietIndex < quietCount) {
+                            move = quiets[quietIndex++];
+                            if (not handedOut(move)) {
+                                return true;
+                            }
+                        }
+                        stage = BadCaptures;
+                        break;
+                    case BadCaptures:
+                        if (pickCapture(move, false)) {
+                            return true;
+                        }
+                        stage = Done;
+                        break;
+                    case Done:
+                        return false;
+                }
+            }
+        }
+
+        //neither a capture nor a promotion, what the killer moves are made of
+        bool quiet(Move move) const {
+            Piece piece = board[move.From()].Piece();
+            bool enPassant = piece == Pawn and move.To() == board.EnPassantSquare();
+            return board[move.To()].Piece() == NAP and move.Promotion() == NAP and not enPassant;
+        }
+};
+
+#endif //MOVEPICKER_H
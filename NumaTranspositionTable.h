@@ -0,0 +1,144 @@
+//
+// Transposition table interleaved page by page over all NUMA nodes (mmap + mbind(MPOL_INTERLEAVE)).
+// Has the same indexing interface as StockDory::TranspositionTable, so the hash-backed searches in Engine can run on
+// either. Probes from threads on every node are spread evenly instead of all landing on the node of the thread that
+// happened to allocate the table. Single node machines and systems without mbind get plain memory.
+//
+
+#ifndef NUMATRANSPOSITIONTABLE_H
+#define NUMATRANSPOSITIONTABLE_H
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Backend/Type/Zobrist.h"
+#include "External/fastrange.h"
+#include "Sysfs.h"
+
+template<typename T>
+class NumaTranspositionTable
+{
+
+    private:
+        T*       Internal    = nullptr;
+        uint64_t Count       = 0;
+        bool     Mapped      = false;
+        bool     Interleaved = false;
+
+        void Allocate()
+        {
+            const uint64_t bytes = std::max<uint64_t>(Count, 1) * sizeof(T);
+
+#ifdef __linux__
+            void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory != MAP_FAILED) {
+                Mapped   = true;
+                Internal = static_cast<T*>(memory);
+
+#ifdef SYS_mbind
+                // The policy has to be set before the pages are first touched, the constructors below do that.
+                constexpr int      InterleavePolicy = 3; // MPOL_INTERLEAVE
+                constexpr uint64_t MaskBits         = 1024;
+                const std::vector<int> nodes = Sysfs::readList("/sys/devices/system/node/online");
+                if (nodes.size() > 1) {
+                    unsigned long mask[MaskBits / (8 * sizeof(unsigned long))] = {};
+                    for (const int node : nodes)
+                        if (node >= 0 && node < static_cast<int>(MaskBits))
+                            mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+
+                    Interleaved = syscall(SYS_mbind, memory, bytes, InterleavePolicy, mask, MaskBits, 0) == 0;
+                }
+#endif
+            }
+#endif
+
+            if (!Mapped) Internal = static_cast<T*>(::operator new(bytes, std::align_val_t(64)));
+
+            for (uint64_t i = 0; i < Count; i++) std::construct_at(Internal + i);
+        }
+
+        void Release()
+        {
+            if (Internal == nullptr) return;
+
+            std::destroy(Internal, Internal + Count);
+
+#ifdef __linux__
+            if (Mapped) munmap(Internal, std::max<uint64_t>(Count, 1) * sizeof(T));
+#endif
+            if (!Mapped) ::operator delete(Internal, std::align_val_t(64));
+
+            Internal    = nullptr;
+            Mapped      = false;
+            Interleaved = false;
+        }
+
+    public:
+        explicit NumaTranspositionTable(const uint64_t bytes)
+        {
+            Resize(bytes);
+        }
+
+        NumaTranspositionTable(const NumaTranspositionTable&) = delete;
+        NumaTranspositionTable& operator =(const NumaTranspositionTable&) = delete;
+
+        ~NumaTranspositionTable()
+        {
+            Release();
+        }
+
+        void Resize(const uint64_t bytes)
+        {
+            Release();
+
+            Count = bytes / sizeof(T);
+
+            Allocate();
+        }
+
+        // Entries are reset in place, so the pages keep the placement they got when the table was allocated.
+        void Clear()
+        {
+            std::destroy(Internal, Internal + Count);
+            for (uint64_t i = 0; i < Count; i++) std::construct_at(Internal + i);
+        }
+
+        inline T& operator [](const ZobristHash hash)
+        {
+            return Internal[fastrange64(hash, Count)];
+        }
+
+        inline const T& operator [](const ZobristHash hash) const
+        {
+            return Internal[fastrange64(hash, Count)];
+        }
+
+        inline void Prefetch(const ZobristHash hash) const
+        {
+            __builtin_prefetch(reinterpret_cast<const char*>(&Internal[fastrange64(hash, Count)]), 0, 3);
+        }
+
+        [[nodiscard]]
+        inline uint64_t Size() const
+        {
+            return Count;
+        }
+
+        // Whether the pages are spread over more than one NUMA node.
+        [[nodiscard]]
+        inline bool NumaInterleaved() const
+        {
+            return Interleaved;
+        }
+
+};
+
+#endif //NUMATRANSPOSITIONTABLE_H
@@ -0,0 +1,357 @@
+//
+// Depth-first proof-number search (df-pn) mate solver: proves or disproves that the side to move mates within N moves.
+// Proof and disproof numbers count how many leaves still have to be solved, so the search always works on the
+// cheapest way to settle the root instead of searching every move to full depth.
+// Several threads can prove the same root together: they share one lockless table and every thread inside a node
+// makes its children look more expensive to the others (virtual proof numbers), so they spread over different moves.
+//
+
+#ifndef PROOFNUMBERSEARCH_H
+#define PROOFNUMBERSEARCH_H
+
+#include <array>
+#include <atomic>
+#include <utility>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <omp.h>
+
+#include "Backend/Board.h"
+#include "Backend/Type/Move.h"
+#include "Backend/Type/Color.h"
+#include "External/fastrange.h"
+#include "SimplifiedMoveList.h"
+
+// Same lockless scheme as SearchEntry, a torn entry reads back as a miss.
+struct ProofEntry
+{
+
+    private:
+        // [ DISPROOF ] [  PROOF   ]
+        // [  32 BITS ] [ 32 BITS  ]
+        std::atomic<uint64_t> Key       {0};
+        std::atomic<uint64_t> Data      {0};
+        // Threads currently searching below this slot, only a hint so it may belong to another position.
+        std::atomic<uint32_t> Searchers {0};
+
+    public:
+        inline void Store(const uint64_t key, const uint32_t proof, const uint32_t disproof)
+        {
+            const uint64_t data = static_cast<uint64_t>(proof) | static_cast<uint64_t>(disproof) << 32;
+
+            Key .store(key ^ data, std::memory_order_relaxed);
+            Data.store(data      , std::memory_order_relaxed);
+        }
+
+        // Proof and disproof are never both 0, so an empty slot cannot pass for a stored one.
+        inline bool Probe(const uint64_t key, uint32_t& proof, uint32_t& disproof) const
+        {
+            const uint64_t data  = Data.load(std::memory_order_relaxed);
+            const uint64_t found = Key .load(std::memory_order_relaxed);
+
+            if ((found ^ data) != key || data == 0) return false;
+
+            proof    = static_cast<uint32_t>(data);
+            disproof = static_cast<uint32_t>(data >> 32);
+
+            return true;
+        }
+
+        inline void Enter() { Searchers.fetch_add(1, std::memory_order_relaxed); }
+
+        inline void Leave() { Searchers.fetch_sub(1, std::memory_order_relaxed); }
+
+        inline uint32_t Busy() const { return Searchers.load(std::memory_order_relaxed); }
+
+};
+
+template<int maxDepth>
+class ProofNumberSearch {
+    private:
+        static constexpr uint32_t Infinity = 1u << 30;
+
+        std::vector<ProofEntry> table;
+        Color attacker = White;
+        uint64_t nodes = 0;
+        //set once the root is settled, the other threads unwind without finishing their subtrees
+        std::atomic<bool> solved{false};
+
+        //the same position with fewer plies left is a different problem, so the plies left are part of the key
+        static uint64_t key(uint64_t hash, int plies) {
+            return hash ^ (0x9E3779B97F4A7C15ull * (plies + 1));
+        }
+
+        ProofEntry &slot(uint64_t hash, int plies) {
+            return table[fastrange64(key(hash, plies), table.size())];
+        }
+
+        bool probe(uint64_t hash, int plies, uint32_t &proof, uint32_t &disproof) {
+            return slot(hash, plies).Probe(key(hash, plies), proof, disproof);
+        }
+
+        void store(uint64_t hash, int plies, uint32_t proof, uint32_t disproof) {
+            slot(hash, plies).Store(key(hash, plies), proof, disproof);
+        }
+
+        static uint32_t add(uint32_t a, uint32_t b) {
+            return std::min(Infinity, a + b);
+        }
+
+        //with one ply left the attacker has to mate right now -> only checking moves can do it,
+        //and the defender only ever answers them with evasions
+        template<Color color>
+        std::pair<uint32_t, uint32_t> search(StockDory::Board &chessBoard, int plies, uint32_t proofThreshold, uint32_t disproofThreshold,
+                                             uint64_t &visited) {
+            return plies == 1 ?
+                    mid<color, StockDory::ChecksOnly>(chessBoard, plies, proofThreshold, disproofThreshold, visited) :
+                    mid<color, StockDory::AllMoves>(chessBoard, plies, proofThreshold, disproofThreshold, visited);
+        }
+
+        //multiple iterative deepening -> stays below this node until its numbers reach one of the thresholds.
+        //Returns the numbers it ended with, the table entry may already be gone by the time the parent looks.
+        template<Color color, StockDory::GenerationMode mode>
+        std::pair<uint32_t, uint32_t> mid(StockDory::Board &chessBoard, int plies, uint32_t proofThreshold, uint32_t disproofThreshold,
+                                          uint64_t &visited) {
+            visited++;
+            const uint64_t hash = chessBoard.Zobrist();
+            const bool orNode = color == attacker;
+            const StockDory::SimplifiedMoveList<color, mode> moveList(chessBoard);
+            //no moves -> mate is a proof if the defender is the one mated, anything else is a disproof
+            //leaves are not stored, there are far more of them than entries and they are cheap to redo
+            if (moveList.Count() == 0) {
+                bool proven = not orNode and chessBoard.Checked<color>();
+                return proven ? std::make_pair(0u, Infinity) : std::make_pair(Infinity, 0u);
+            }
+            //out of plies and nobody is mated
+            if (plies == 0) {
+                return std::make_pair(Infinity, 0u);
+            }
+
+            constexpr enum Color Ocolor = Opposite(color);
+            //numbers of the children, from the table when they have been seen before.
+            //A new child starts from its number of replies -> a defender with few moves left is cheap to prove,
+            //an attacker with few moves cheap to disprove. Mates, stalemates and the last ply are settled right here.
+            std::array<uint32_t, 256> childProof;
+            std::array<uint32_t, 256> childDisproof;
+            std::array<uint64_t, 256> childHash;
+            for (uint8_t i = 0; i < moveList.Count(); i++) {
+                Move nextMove = moveList[i];
+                PreviousState prevState = chessBoard.Move<ZOBRIST>(nextMove.From(), nextMove.To(), nextMove.Promotion());
+                childHash[i] = chessBoard.Zobrist();
+                if (not probe(childHash[i], plies - 1, childProof[i], childDisproof[i])) {
+                    //an attacker with one ply left only counts its checks, without one it cannot mate at all
+                    const uint8_t replies = mode == StockDory::ChecksOnly ?
+                            StockDory::SimplifiedMoveList<Ocolor, StockDory::Evasions>(chessBoard).Count() : plies == 2 ?
+                            StockDory::SimplifiedMoveList<Ocolor, StockDory::ChecksOnly>(chessBoard).Count() :
+                            StockDory::SimplifiedMoveList<Ocolor>(chessBoard).Count();
+                    uint32_t mobility = std::max<uint32_t>(1, replies);
+                    if (replies == 0) {
+                        bool proven = orNode and chessBoard.Checked<Ocolor>();
+                        childProof[i] = proven ? 0 : Infinity;
+                        childDisproof[i] = proven ? Infinity : 0;
+                    }
+                    else if (plies == 1) {
+                        childProof[i] = Infinity;
+                        childDisproof[i] = 0;
+                    }
+                    else {
+                        childProof[i] = orNode ? mobility : 1;
+                        childDisproof[i] = orNode ? 1 : mobility;
+                    }
+                }
+                chessBoard.UndoMove<ZOBRIST>(prevState, nextMove.From(), nextMove.To());
+            }
+
+            ProofEntry &self = slot(hash, plies);
+            self.Enter();
+            bool first = true;
+            while (true) {
+                //other threads may have moved the children on since the last look
+                if (not first) {
+                    for (uint8_t i = 0; i < moveList.Count(); i++) {
+                        probe(childHash[i], plies - 1, childProof[i], childDisproof[i]);
+                    }
+                }
+                first = false;
+
+                //at an OR node the attacker needs one proven move and every move disproven to fail,
+                //at an AND node it is the other way around -> phi is the number to keep small, delta the other one.
+                //The child is picked on phi plus one more phi for every thread already below it, the real numbers
+                //are the ones that get stored and compared against the thresholds.
+                uint32_t phi = Infinity;
+                uint32_t delta = 0;
+                uint8_t cheapest = 0;
+                uint32_t virtualPhi = Infinity;
+                uint32_t secondVirtualPhi = Infinity;
+                uint8_t best = 0;
+                for (uint8_t i = 0; i < moveList.Count(); i++) {
+                    uint32_t childPhi = orNode ? childProof[i] : childDisproof[i];
+                    uint32_t childDelta = orNode ? childDisproof[i] : childProof[i];
+                    delta = add(delta, childDelta);
+                    if (childPhi < phi) {
+                        phi = childPhi;
+                        cheapest = i;
+                    }
+                    uint32_t busy = childPhi == 0 ? 0 : slot(childHash[i], plies - 1).Busy();
+                    uint32_t childVirtualPhi = std::min<uint64_t>(Infinity, (uint64_t) childPhi * (busy + 1));
+                    if (childVirtualPhi < virtualPhi) {
+                        secondVirtualPhi = virtualPhi;
+                        virtualPhi = childVirtualPhi;
+                        best = i;
+                    }
+                    else if (childVirtualPhi < secondVirtualPhi) {
+                        secondVirtualPhi = childVirtualPhi;
+                    }
+                }
+                uint32_t proof = orNode ? phi : delta;
+                uint32_t disproof = orNode ? delta : phi;
+                if (proof >= proofThreshold or disproof >= disproofThreshold or solved.load(std::memory_order_relaxed)) {
+                    self.Leave();
+                    store(hash, plies, proof, disproof);
+                    return std::make_pair(proof, disproof);
+                }
+
+                //stay in the best child until it looks worse than the second best
+                uint32_t phiThreshold = orNode ? proofThreshold : disproofThreshold;
+                uint32_t deltaThreshold = orNode ? disproofThreshold : proofThreshold;
+                uint32_t bestPhi = orNode ? childProof[best] : childDisproof[best];
+                uint32_t childPhiThreshold = std::min(phiThreshold, std::max(add(secondVirtualPhi, 1), add(bestPhi, 1)));
+                //the crowded child is already over what this node may spend -> back to the cheapest one
+                if (childPhiThreshold <= bestPhi) {
+                    best = cheapest;
+                    bestPhi = phi;
+                    childPhiThreshold = phiThreshold;
+                }
+                uint32_t childDeltaThreshold = deltaThreshold - delta + (orNode ? childDisproof[best] : childProof[best]);
+                Move nextMove = moveList[best];
+                PreviousState prevState = chessBoard.Move<ZOBRIST>(nextMove.From(), nextMove.To(), nextMove.Promotion());
+                std::pair<uint32_t, uint32_t> numbers = orNode ?
+                        search<Ocolor>(chessBoard, plies - 1, childPhiThreshold, childDeltaThreshold, visited) :
+                        search<Ocolor>(chessBoard, plies - 1, childDeltaThreshold, childPhiThreshold, visited);
+                childProof[best] = numbers.first;
+                childDisproof[best] = numbers.second;
+                chessBoard.UndoMove<ZOBRIST>(prevState, nextMove.From(), nextMove.To());
+            }
+        }
+
+        template<Color color>
+        bool prove(StockDory::Board &chessBoard, int plies) {
+            uint32_t proof, disproof;
+            if (probe(chessBoard.Zobrist(), plies, proof, disproof) and (proof == 0 or disproof == 0)) {
+                return proof == 0;
+            }
+            return search<color>(chessBoard, plies, Infinity, Infinity, nodes).first == 0;
+        }
+
+        //every thread runs the whole search from the root, the first one to settle it stops the rest
+        template<Color color>
+        bool proveParallel(const StockDory::Board &chessBoard, int plies, int threads) {
+            uint32_t proof, disproof;
+            if (probe(chessBoard.Zobrist(), plies, proof, disproof) and (proof == 0 or disproof == 0)) {
+                return proof == 0;
+            }
+            solved.store(false);
+            std::atomic<int> result{-1};
+            uint64_t visited = 0;
+            #pragma omp parallel num_threads(threads) reduction(+:visited)
+            {
+                StockDory::Board board = chessBoard;
+                std::pair<uint32_t, uint32_t> numbers = search<color>(board, plies, Infinity, Infinity, visited);
+                if (numbers.first == 0 or numbers.second == 0) {
+                    int expected = -1;
+                    result.compare_exchange_strong(expected, numbers.first == 0 ? 1 : 0);
+                    solved.store(true, std::memory_order_relaxed);
+                }
+            }
+            solved.store(false);
+            nodes += visited;
+            return result.load() == 1;
+        }
+
+        //fewest plies, up to the given ones, in which this position is still a proven mate
+        template<Color color>
+        uint32_t distance(StockDory::Board &chessBoard, int plies) {
+            for (int p = plies % 2; p <= plies; p += 2) {
+                if (prove<color>(chessBoard, p)) {
+                    return p;
+                }
+            }
+            return Infinity;
+        }
+
+        //attacker plays the quickest mate, the defender the move that holds out the longest
+        template<Color color>
+        void extractLine(StockDory::Board &chessBoard, int plies, std::array<Move, maxDepth> &line, int index) {
+            if (plies == 0 or index >= maxDepth) {
+                return;
+            }
+            constexpr enum Color Ocolor = Opposite(color);
+            const StockDory::SimplifiedMoveList<color> moveList(chessBoard);
+            bool found = false;
+            uint32_t bestDistance = 0;
+            Move bestMove;
+            for (uint8_t i = 0; i < moveList.Count(); i++) {
+                Move nextMove = moveList[i];
+                PreviousState prevState = chessBoard.Move<ZOBRIST>(nextMove.From(), nextMove.To(), nextMove.Promotion());
+                uint32_t childDistance = distance<Ocolor>(chessBoard, plies - 1);
+                chessBoard.UndoMove<ZOBRIST>(prevState, nextMove.From(), nextMove.To());
+                if (childDistance == Infinity) {
+                    continue;
+                }
+                if (not found or (color == attacker ? childDistance < bestDistance : childDistance > bestDistance)) {
+                    found = true;
+                    bestDistance = childDistance;
+                    bestMove = nextMove;
+                }
+            }
+            if (not found) {
+                return;
+            }
+            line[index] = bestMove;
+            PreviousState prevState = chessBoard.Move<ZOBRIST>(bestMove.From(), bestMove.To(), bestMove.Promotion());
+            extractLine<Ocolor>(chessBoard, bestDistance, line, index + 1);
+            chessBoard.UndoMove<ZOBRIST>(prevState, bestMove.From(), bestMove.To());
+        }
+
+    public:
+        struct Result {
+            bool mate;
+            //moves of the side to move until mate, 0 when there is none
+            int moves;
+            std::array<Move, maxDepth> line;
+            //nodes visited over all the iterations
+            uint64_t nodes;
+        };
+
+        explicit ProofNumberSearch(size_t bytes = 16 * 1024 * 1024) : table(std::max<size_t>(1, bytes / sizeof(ProofEntry))) {}
+
+        //tries mate in 1, 2, ... maxMoves so the first proof is also the shortest mate.
+        //The proofs run on the given number of threads, the line is read off the table by one of them afterwards.
+        Result solve(const StockDory::Board &chessBoard, int maxMoves, int threads = 1) {
+            table = std::vector<ProofEntry>(table.size());
+            StockDory::Board board = chessBoard;
+            attacker = board.ColorToMove();
+            nodes = 0;
+            Result result = {false, 0, std::array<Move, maxDepth>(), 0};
+            for (int moves = 1; moves <= maxMoves and 2 * moves - 1 <= maxDepth; moves++) {
+                int plies = 2 * moves - 1;
+                bool proven = attacker == White ? proveParallel<White>(board, plies, threads) : proveParallel<Black>(board, plies, threads);
+                if (proven) {
+                    result.mate = true;
+                    result.moves = moves;
+                    if (attacker == White) {
+                        extractLine<White>(board, plies, result.line, 0);
+                    }
+                    else {
+                        extractLine<Black>(board, plies, result.line, 0);
+                    }
+                    break;
+                }
+            }
+            result.nodes = nodes;
+            return result;
+        }
+};
+
+#endif //PROOFNUMBERSEARCH_H
@@ -0,0 +1,81 @@
+//
+// Transposition table entry for the engine's hash-backed searches.
+// The key is stored xor-ed with the data (lockless hashing), so an entry torn by a concurrent write from another
+// thread reads back as a miss instead of as a wrong score.
+//
+
+#ifndef SEARCHENTRY_H
+#define SEARCHENTRY_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "Backend/Type/Move.h"
+#include "Backend/Type/Zobrist.h"
+
+enum Bound : uint8_t
+{
+
+    ExactBound,
+    LowerBound,
+    UpperBound
+
+};
+
+// Decoded copy of an entry, private to the probing thread.
+struct SearchHit
+{
+
+    public:
+        Move  BestMove;
+        int   Score = 0;
+        int   Depth = 0;
+        Bound Type  = ExactBound;
+
+};
+
+struct SearchEntry
+{
+
+    private:
+        // [   SCORE   ] [   BOUND   ] [   DEPTH   ] [   MOVE   ]
+        // [  32 BITS  ] [   8 BITS  ] [   8 BITS  ] [ 16 BITS  ]
+        std::atomic<uint64_t> Key  {0};
+        std::atomic<uint64_t> Data {0};
+
+    public:
+        inline void Store(const ZobristHash hash, const Move move, const int score, const int depth, const Bound bound)
+        {
+            const uint64_t moveBits = static_cast<uint64_t>(move.From())      |
+                                      static_cast<uint64_t>(move.To())        << 6 |
+                                      static_cast<uint64_t>(move.Promotion()) << 12;
+            const uint64_t data     = moveBits                                                     |
+                                      static_cast<uint64_t>(static_cast<uint8_t >(depth)) << 16    |
+                                      static_cast<uint64_t>(bound)                         << 24    |
+                                      static_cast<uint64_t>(static_cast<uint32_t>(score)) << 32;
+
+            Key .store(hash ^ data, std::memory_order_relaxed);
+            Data.store(data       , std::memory_order_relaxed);
+        }
+
+        // Decodes the entry into hit, returns false if the slot holds a different position.
+        inline bool Probe(const ZobristHash hash, SearchHit& hit) const
+        {
+            const uint64_t data = Data.load(std::memory_order_relaxed);
+            const uint64_t key  = Key .load(std::memory_order_relaxed);
+
+            if ((key ^ data) != hash || data == 0) return false;
+
+            hit.BestMove = Move(static_cast<Square>(data & 0x3F),
+                                static_cast<Square>((data >> 6) & 0x3F),
+                                static_cast<Piece >((data >> 12) & 0x0F));
+            hit.Depth    = static_cast<uint8_t>(data >> 16);
+            hit.Type     = static_cast<Bound  >(static_cast<uint8_t>(data >> 24));
+            hit.Score    = static_cast<int32_t>(static_cast<uint32_t>(data >> 32));
+
+            return true;
+        }
+
+};
+
+#endif //SEARCHENTRY_H
@@ -0,0 +1,106 @@
+//
+// Transposition table backed by POSIX shared memory (shm_open + mmap).
+// Has the same indexing interface as StockDory::TranspositionTable, so the hash-backed searches in Engine can run on
+// either. Every process that maps the same name sees the same entries, and entries written by a process that dies
+// stay in the table for the others.
+//
+
+#ifndef SHAREDTRANSPOSITIONTABLE_H
+#define SHAREDTRANSPOSITIONTABLE_H
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <string>
+#include <new>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "Backend/Type/Zobrist.h"
+#include "External/fastrange.h"
+
+template<typename T>
+class SharedTranspositionTable
+{
+
+    private:
+        std::string Name;
+        T*          Internal = nullptr;
+        uint64_t    Count    = 0;
+        bool        Owner    = false;
+
+    public:
+        // create = true makes a new segment (replacing a stale one of the same name), otherwise an existing segment
+        // created by another process is attached to.
+        SharedTranspositionTable(const std::string& name, const uint64_t bytes, const bool create = true)
+        {
+            Name  = name;
+            Count = bytes / sizeof(T);
+            Owner = create;
+
+            if (create) shm_unlink(Name.c_str());
+
+            const int fd = shm_open(Name.c_str(), create ? O_CREAT | O_RDWR : O_RDWR, 0600);
+            if (fd < 0) throw std::runtime_error("shm_open failed for " + Name);
+
+            if (create && ftruncate(fd, static_cast<off_t>(Count * sizeof(T))) != 0) {
+                close(fd);
+                shm_unlink(Name.c_str());
+                throw std::runtime_error("ftruncate failed for " + Name);
+            }
+
+            void* memory = mmap(nullptr, Count * sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+
+            if (memory == MAP_FAILED) {
+                if (create) shm_unlink(Name.c_str());
+                throw std::runtime_error("mmap failed for " + Name);
+            }
+
+            Internal = static_cast<T*>(memory);
+
+            if (create) Clear();
+        }
+
+        SharedTranspositionTable(const SharedTranspositionTable&) = delete;
+        SharedTranspositionTable& operator =(const SharedTranspositionTable&) = delete;
+
+        ~SharedTranspositionTable()
+        {
+            if (Internal) munmap(Internal, Count * sizeof(T));
+            if (Owner) shm_unlink(Name.c_str());
+        }
+
+        void Clear()
+        {
+            for (uint64_t i = 0; i < Count; i++) new (&Internal[i]) T();
+        }
+
+        inline T& operator [](const ZobristHash hash)
+        {
+            return Internal[fastrange64(hash, Count)];
+        }
+
+        inline const T& operator [](const ZobristHash hash) const
+        {
+            return Internal[fastrange64(hash, Count)];
+        }
+
+        inline void Prefetch(const ZobristHash hash) const
+        {
+            __builtin_prefetch(reinterpret_cast<const char*>(&Internal[fastrange64(hash, Count)]), 0, 3);
+        }
+
+        [[nodiscard]]
+        inline uint64_t Size() const
+        {
+            return Count;
+        }
+
+};
+
+#endif
+
+#endif //SHAREDTRANSPOSITIONTABLE_H
@@ -9,13 +9,30 @@
 #include <array>
 #include <cassert>
 
+#include "Backend/Move/AttackTable.h"
 #include "Backend/Move/MoveList.h"
+#include "Backend/Move/UtilityTable.h"
 #include "Backend/Type/Move.h"
 
 namespace StockDory
 {
 
-    template<Color Color, bool CaptureOnly = false>
+    enum GenerationMode : uint8_t
+    {
+
+        AllMoves,
+        // Captures and every promotion, a promotion push wins material like a capture does.
+        CaptureOnly,
+        // Everything CaptureOnly leaves out, the two together are all moves.
+        Quiets,
+        // Only moves that give check, direct or discovered.
+        ChecksOnly,
+        // Only replies to a check, nothing when the side to move is not in check.
+        Evasions
+
+    };
+
+    template<Color Color, GenerationMode Mode = AllMoves>
     class SimplifiedMoveList
     {
 
@@ -24,12 +41,35 @@ namespace StockDory
         std::array<Move, MaxMove> Internal = {};  // Array of moves without ordering
         uint8_t Size = 0;
 
+        // Only filled in for ChecksOnly.
+        Square   EnemyKing = NASQ;
+        BitBoard Occupied  = BBDefault;
+        BitBoard Lines     = BBDefault;  // Squares between the enemy king and our sliders aimed at it
+
     public:
         explicit SimplifiedMoveList(const Board& board)
         {
             const PinBitBoard   pin   = board.Pin  <Color, Opposite(Color)>();
             const CheckBitBoard check = board.Check<Opposite(Color)>();
 
+            if (Mode == Evasions && check.Check == BBFilled) return;
+
+            if (Mode == ChecksOnly) {
+                EnemyKing = ToSquare(board.PieceBoard<Opposite(Color)>(King));
+                Occupied  = ~board[NAC];
+
+                // A piece of ours on one of these squares can uncover a check by moving off the line.
+                const BitBoard queen    = board.PieceBoard<Color>(Queen);
+                const BitBoard diagonal = AttackTable::Sliding[BlackMagicFactory::MagicIndex(Bishop, EnemyKing, BBDefault)] &
+                                          (queen | board.PieceBoard<Color>(Bishop));
+                const BitBoard straight = AttackTable::Sliding[BlackMagicFactory::MagicIndex(Rook  , EnemyKing, BBDefault)] &
+                                          (queen | board.PieceBoard<Color>(Rook  ));
+
+                BitBoardIterator iterator (diagonal | straight);
+                for (Square sq = iterator.Value(); sq != NASQ; sq = iterator.Value())
+                    Lines |= UtilityTable::Between[EnemyKing][sq];
+            }
+
             if (check.DoubleCheck) {
                 AddMoveLoop<King>(board, pin, check);
             } else {
@@ -51,32 +91,94 @@ namespace StockDory
 
             for (Square sq = iterator.Value(); sq != NASQ; sq = iterator.Value()) {
                 const MoveList<Piece, Color> moves(board, sq, pin, check);
-                BitBoardIterator moveIterator = CaptureOnly ?
-                        (Piece == Pawn ?
+                const bool promotion = Piece == Pawn && moves.Promotion(sq);
+                BitBoardIterator moveIterator = Mode == CaptureOnly ?
+                        (promotion ? moves :
+                         Piece == Pawn ?
                          moves.Mask(~board[NAC] | board.EnPassant()) :
                          moves.Mask(~board[NAC])).Iterator() :
+                        Mode == Quiets ?
+                        (promotion ? moves.Mask(BBDefault) :
+                         Piece == Pawn ?
+                         moves.Mask(board[NAC] & ~board.EnPassant()) :
+                         moves.Mask(board[NAC])).Iterator() :
                          moves.Iterator();
 
                 for (Square m = moveIterator.Value(); m != NASQ; m = moveIterator.Value()) {
                     if (moves.Promotion(sq)) {
-                        Internal[Size++] = CreateMove<Piece, Queen>(sq, m);
-                        Internal[Size++] = CreateMove<Piece, Knight>(sq, m);
-                        Internal[Size++] = CreateMove<Piece, Rook>(sq, m);
-                        Internal[Size++] = CreateMove<Piece, Bishop>(sq, m);
+                        AddMove<Piece, Queen>(board, sq, m);
+                        AddMove<Piece, Knight>(board, sq, m);
+                        AddMove<Piece, Rook>(board, sq, m);
+                        AddMove<Piece, Bishop>(board, sq, m);
                     } else {
-                        Internal[Size++] = CreateMove<Piece>(sq, m);
+                        AddMove<Piece>(board, sq, m);
                     }
                 }
             }
         }
 
     private:
+        template<Piece Piece, enum Piece Promotion = NAP>
+        inline void AddMove(const Board& board, const Square from, const Square to)
+        {
+            if (Mode == ChecksOnly && !GivesCheck<Piece, Promotion>(board, from, to)) return;
+
+            Internal[Size++] = CreateMove<Piece, Promotion>(from, to);
+        }
+
         template<Piece Piece, enum Piece Promotion = NAP>
         inline Move CreateMove(const Square from, const Square to)
         {
             return Move(from, to, Promotion);  // Simplified move creation without ordering
         }
 
+        // Looks at the occupancy after the move instead of making it.
+        template<Piece Piece, enum Piece Promotion>
+        [[nodiscard]]
+        inline bool GivesCheck(const Board& board, const Square from, const Square to) const
+        {
+            constexpr enum Piece Moved = Promotion != NAP ? Promotion : Piece;
+
+            const BitBoard king      = FromSquare(EnemyKing);
+            BitBoard       occupied  = (Occupied & ~FromSquare(from)) | FromSquare(to);
+            BitBoard       rooks     = board.PieceBoard<Color>(Rook);
+            bool           uncovered = Get(Lines, from);
+
+            // En passant also takes the captured pawn off its square.
+            if (Piece == Pawn && to == board.EnPassantSquare()) {
+                occupied  &= ~FromSquare(static_cast<Square>(to ^ 8));
+                uncovered  = true;
+            }
+
+            // Castling, the rook jumps over the king and may be the one giving check.
+            if (Piece == King && (from == to + 2 || to == from + 2)) {
+                const auto rookFrom = static_cast<Square>(to > from ? to + 1 : to - 2);
+                const auto rookTo   = static_cast<Square>(to > from ? to - 1 : to + 1);
+
+                occupied = (occupied & ~FromSquare(rookFrom)) | FromSquare(rookTo);
+                rooks    = (rooks    & ~FromSquare(rookFrom)) | FromSquare(rookTo);
+                uncovered = true;
+            }
+
+            // Direct check by the piece on its new square.
+            if (Moved == Pawn   && AttackTable::Pawn[Color][to] & king) return true;
+            if (Moved == Knight && AttackTable::Knight     [to] & king) return true;
+            if ((Moved == Bishop || Moved == Queen) &&
+                AttackTable::Sliding[BlackMagicFactory::MagicIndex(Bishop, to, occupied)] & king) return true;
+            if ((Moved == Rook   || Moved == Queen) &&
+                AttackTable::Sliding[BlackMagicFactory::MagicIndex(Rook  , to, occupied)] & king) return true;
+
+            if (!uncovered) return false;
+
+            // Discovered check by one of our sliders that stayed put.
+            const BitBoard queen    = board.PieceBoard<Color>(Queen);
+            const BitBoard diagonal = (queen | board.PieceBoard<Color>(Bishop)) & ~FromSquare(from);
+            const BitBoard straight = (queen | rooks                          ) & ~FromSquare(from);
+
+            return AttackTable::Sliding[BlackMagicFactory::MagicIndex(Bishop, EnemyKing, occupied)] & diagonal ||
+                   AttackTable::Sliding[BlackMagicFactory::MagicIndex(Rook  , EnemyKing, occupied)] & straight;
+        }
+
     public:
         [[nodiscard]]
         inline Move operator [](const uint8_t index) const
@@ -93,6 +195,29 @@ namespace StockDory
 
     };
 
+    // Finishes the check of a move that passed Board::IsPseudoLegal, with the same pin and check rules the list uses.
+    template<Color Color>
+    inline bool IsLegal(const Board& board, const Move move)
+    {
+        const PinBitBoard   pin   = board.Pin  <Color, Opposite(Color)>();
+        const CheckBitBoard check = board.Check<Opposite(Color)>();
+
+        const Square   from = move.From();
+        const BitBoard to   = FromSquare(move.To());
+
+        if (check.DoubleCheck) return board[from].Piece() == King && MoveList<King, Color>(board, from, pin, check).Mask(to).Count();
+
+        switch (board[from].Piece()) {
+            case Pawn  : return MoveList<Pawn  , Color>(board, from, pin, check).Mask(to).Count();
+            case Knight: return MoveList<Knight, Color>(board, from, pin, check).Mask(to).Count();
+            case Bishop: return MoveList<Bishop, Color>(board, from, pin, check).Mask(to).Count();
+            case Rook  : return MoveList<Rook  , Color>(board, from, pin, check).Mask(to).Count();
+            case Queen : return MoveList<Queen , Color>(board, from, pin, check).Mask(to).Count();
+            case King  : return MoveList<King  , Color>(board, from, pin, check).Mask(to).Count();
+            default    : return false;
+        }
+    }
+
 } // StockDory
 
 #endif //STOCKDORY_SIMPLIFIEDMOVELIST_H
@@ -0,0 +1,50 @@
+//
+// Reading /sys. Cpus and NUMA nodes are listed there as ranges, "0-3,8,10-11", one line per file. Both the thread
+// placement and the NUMA policy of the transposition table read them through here.
+//
+
+#ifndef SYSFS_H
+#define SYSFS_H
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class Sysfs {
+    public:
+        //first line of the file, empty where it cannot be read
+        static std::string readLine(const std::string &path) {
+            std::ifstream file(path);
+            std::string line;
+            std::getline(file, line);
+            return line;
+        }
+
+        //"0-3,8,10-11" -> 0 1 2 3 8 10 11, empty when the list is malformed
+        static std::vector<int> parseList(const std::string &list) {
+            std::vector<int> ids;
+            std::stringstream stream(list);
+            std::string range;
+            while (std::getline(stream, range, ',')) {
+                size_t dash = range.find('-');
+                try {
+                    int first = std::stoi(range.substr(0, dash));
+                    int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                    for (int id = first; id <= last; id++) {
+                        ids.push_back(id);
+                    }
+                }
+                catch (const std::exception &) {
+                    return {};
+                }
+            }
+            return ids;
+        }
+
+        static std::vector<int> readList(const std::string &path) {
+            return parseList(readLine(path));
+        }
+};
+
+#endif //SYSFS_H
@@ -0,0 +1,346 @@
+//
+// Search threads that live as long as the process. A split point hands its moves to whichever members are idle right
+// now, at any nesting level, instead of opening a parallel region that has to create or wake a team every time.
+// Idle members spin first, then yield, then sleep on a futex (std::atomic::wait), so a split that comes shortly after
+// the last one finds them awake.
+//
+
+#ifndef THREADTEAM_H
+#define THREADTEAM_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Affinity.h"
+
+class ThreadTeam {
+    public:
+        struct Config {
+            //how long an idle member spins before it starts yielding
+            int spinMicroseconds = 50;
+            //how long it yields after that before it goes to sleep
+            int yieldMicroseconds = 2000;
+            //a caller waiting for its helpers runs jobs handed to it on top of its own stack, this many levels at most
+            int maxNesting = 4;
+        };
+
+        //per slot since the last resetStats, slot 0 is the thread outside the team that calls parallelFor
+        struct Stats {
+            double idleSeconds = 0;
+            uint64_t jobs = 0;
+            //which phase of the wait each job found the member in
+            uint64_t spinWakeups = 0;
+            uint64_t yieldWakeups = 0;
+            uint64_t sleepWakeups = 0;
+        };
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Job {
+            void (*invoke)(void *, int);
+            void *body;
+            int count;
+            std::atomic<int> next{0};
+            //members still working on it
+            std::atomic<int> running{0};
+        };
+
+        struct alignas(64) Member {
+            std::atomic<Job *> job{nullptr};
+            std::atomic<bool> claimed{false};
+            std::atomic<bool> sleeping{false};
+            std::atomic<int64_t> idleNanoseconds{0};
+            std::atomic<uint64_t> jobs{0};
+            std::atomic<uint64_t> spinWakeups{0};
+            std::atomic<uint64_t> yieldWakeups{0};
+            std::atomic<uint64_t> sleepWakeups{0};
+            std::thread thread;
+        };
+
+        std::vector<std::unique_ptr<Member>> members;
+        //slot 0, no thread of its own. Only claimable while the thread outside the team waits in parallelFor.
+        Member caller;
+        std::atomic<bool> callerTaken{false};
+        //members that may be claimed, the others stay asleep
+        std::atomic<int> width{0};
+        std::atomic<int> spinMicroseconds;
+        std::atomic<int> yieldMicroseconds;
+        std::atomic<int> maxNesting;
+        //handed to every member to make it exit
+        Job stop;
+
+        //member of the calling thread, nullptr outside the team
+        static inline thread_local ThreadTeam *currentTeam = nullptr;
+        static inline thread_local Member *current = nullptr;
+        //jobs this thread runs inside a wait of its own
+        static inline thread_local int nesting = 0;
+
+        static void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+
+        static void work(Job &job) {
+            while (true) {
+                int i = job.next.fetch_add(1, std::memory_order_relaxed);
+                if (i >= job.count) {
+                    return;
+                }
+                job.invoke(job.body, i);
+            }
+        }
+
+        Job *waitForJob(Member &member) {
+            Clock::time_point start = Clock::now();
+            int64_t spin = spinMicroseconds.load(std::memory_order_relaxed) * 1000ll;
+            int64_t yield = spin + yieldMicroseconds.load(std::memory_order_relaxed) * 1000ll;
+            int64_t waited = 0;
+            std::atomic<uint64_t> *phase = &member.spinWakeups;
+            for (uint32_t round = 1;; round++) {
+                Job *job = member.job.load(std::memory_order_acquire);
+                if (job != nullptr) {
+                    phase->fetch_add(1, std::memory_order_relaxed);
+                    return job;
+                }
+                //the clock is only read now and then, it costs more than a pause
+                if (round % 64 == 0) {
+                    waited = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+                }
+                if (waited < spin) {
+                    pause();
+                }
+                else if (waited < yield) {
+                    phase = &member.yieldWakeups;
+                    std::this_thread::yield();
+                }
+                else {
+                    //whoever hands out a job checks sleeping after storing it, one of the two always sees the other
+                    phase = &member.sleepWakeups;
+                    member.sleeping.store(true, std::memory_order_seq_cst);
+                    member.job.wait(nullptr, std::memory_order_acquire);
+                    member.sleeping.store(false, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        //the member's part of a job handed to it, after that it can be claimed again
+        static void run(Member &member, Job *job) {
+            member.jobs.fetch_add(1, std::memory_order_relaxed);
+            //emptied first, a wait inside the job watches it for the next one
+            member.job.store(nullptr, std::memory_order_relaxed);
+            work(*job);
+            job->running.fetch_sub(1, std::memory_order_release);
+            member.claimed.store(false, std::memory_order_release);
+        }
+
+        static int64_t nanosecondsSince(Clock::time_point start) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        }
+
+        void loop(Member &member) {
+            currentTeam = this;
+            current = &member;
+            while (true) {
+                Clock::time_point idleStart = Clock::now();
+                Job *job = waitForJob(member);
+                if (job == &stop) {
+                    return;
+                }
+                member.idleNanoseconds.fetch_add(nanosecondsSince(idleStart), std::memory_order_relaxed);
+                run(member, job);
+            }
+        }
+
+        //the helpers of job are finishing their last index. Meanwhile the caller's own member can be claimed by other
+        //split points and runs what they hand it, the rest of the wait is idle time of that member.
+        void finish(Job &job) {
+            Member *self = currentTeam == this ? current : nullptr;
+            bool adopted = false;
+            if (self == nullptr and not callerTaken.exchange(true, std::memory_order_acquire)) {
+                self = &caller;
+                adopted = true;
+                currentTeam = this;
+                current = self;
+            }
+            bool helping = self != nullptr and nesting < maxNesting.load(std::memory_order_relaxed);
+            Clock::time_point start = Clock::now();
+            int64_t busy = 0;
+            if (helping) {
+                self->claimed.store(false, std::memory_order_release);
+            }
+            std::atomic<uint64_t> *phase = self ? &self->spinWakeups : nullptr;
+            for (uint32_t round = 0;; round++) {
+                if (helping) {
+                    Job *other = self->job.load(std::memory_order_acquire);
+                    if (other != nullptr) {
+                        phase->fetch_add(1, std::memory_order_relaxed);
+                        Clock::time_point helpStart = Clock::now();
+                        nesting++;
+                        run(*self, other);
+                        nesting--;
+                        busy += nanosecondsSince(helpStart);
+                        //the wait for the next one starts over
+                        round = 0;
+                        phase = &self->spinWakeups;
+                        continue;
+                    }
+                }
+                if (job.running.load(std::memory_order_acquire) == 0) {
+                    if (not helping) {
+                        break;
+                    }
+                    //whoever claims the member in between is about to hand it a job, that one is run first
+                    bool expected = false;
+                    if (self->claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                        break;
+                    }
+                    continue;
+                }
+                if (round < 4096) {
+                    pause();
+                }
+                else {
+                    if (self) {
+                        phase = &self->yieldWakeups;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+            if (self) {
+                self->idleNanoseconds.fetch_add(nanosecondsSince(start) - busy, std::memory_order_relaxed);
+            }
+            if (adopted) {
+                currentTeam = nullptr;
+                current = nullptr;
+                callerTaken.store(false, std::memory_order_release);
+            }
+        }
+
+        bool tryClaim(Member &member) {
+            bool expected = false;
+            return not member.claimed.load(std::memory_order_relaxed) and
+                   member.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire);
+        }
+
+        void hand(Member &member, Job *job) {
+            member.job.store(job, std::memory_order_seq_cst);
+            if (member.sleeping.load(std::memory_order_seq_cst)) {
+                member.job.notify_one();
+            }
+        }
+
+    public:
+        ThreadTeam() : ThreadTeam(Config()) {}
+
+        explicit ThreadTeam(const Config &config) :
+                spinMicroseconds(config.spinMicroseconds), yieldMicroseconds(config.yieldMicroseconds),
+                maxNesting(config.maxNesting) {
+            //the caller is never claimed outside of its waits
+            caller.claimed.store(true);
+        }
+
+        ThreadTeam(const ThreadTeam &) = delete;
+        ThreadTeam &operator=(const ThreadTeam &) = delete;
+
+        ~ThreadTeam() {
+            for (std::unique_ptr<Member> &member : members) {
+                while (member->claimed.exchange(true, std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                hand(*member, &stop);
+                member->thread.join();
+            }
+        }
+
+        //one team for the whole process
+        static ThreadTeam &shared() {
+            static ThreadTeam team;
+            return team;
+        }
+
+        //threads that may work at once, the caller of parallelFor included. Members are started the first time they
+        //are needed and never stopped, shrinking only stops handing them work. Not to be called during a parallelFor.
+        void resize(int threads) {
+            threads = std::max(1, threads);
+            while ((int) members.size() < threads - 1) {
+                int slot = members.size() + 1;
+                members.push_back(std::make_unique<Member>());
+                Member *member = members.back().get();
+                member->thread = std::thread([this, member, slot] {
+                    //the caller of parallelFor is slot 0
+                    if (Affinity::enabled()) {
+                        Affinity::pinCurrentThread(slot);
+                    }
+                    loop(*member);
+                });
+            }
+            width.store(threads - 1, std::memory_order_release);
+        }
+
+        int size() const {
+            return width.load(std::memory_order_relaxed) + 1;
+        }
+
+        void setConfig(const Config &config) {
+            spinMicroseconds.store(config.spinMicroseconds, std::memory_order_relaxed);
+            yieldMicroseconds.store(config.yieldMicroseconds, std::memory_order_relaxed);
+            maxNesting.store(config.maxNesting, std::memory_order_relaxed);
+        }
+
+        //body(i) for every i below count, on the calling thread and on the members that are idle right now, a caller that
+        //is waiting for its own helpers included. Works from inside a body as well, a nested call just finds fewer.
+        template<typename F>
+        void parallelFor(int count, F &&body) {
+            Job job;
+            job.invoke = [](void *function, int i) {
+                (*static_cast<std::remove_reference_t<F> *>(function))(i);
+            };
+            job.body = &body;
+            job.count = count;
+            int helpers = std::min(count - 1, width.load(std::memory_order_acquire));
+            for (int m = 0; m <= width.load(std::memory_order_relaxed) and helpers > 0; m++) {
+                Member &member = m == 0 ? caller : *members[m - 1];
+                if (tryClaim(member)) {
+                    job.running.fetch_add(1, std::memory_order_relaxed);
+                    hand(member, &job);
+                    helpers--;
+                }
+            }
+            work(job);
+            finish(job);
+        }
+
+        std::vector<Stats> stats() const {
+            std::vector<Stats> result(width.load(std::memory_order_relaxed) + 1);
+            for (size_t m = 0; m < result.size(); m++) {
+                const Member &member = m == 0 ? caller : *members[m - 1];
+                result[m].idleSeconds = member.idleNanoseconds.load() / 1e9;
+                result[m].jobs = member.jobs.load();
+                result[m].spinWakeups = member.spinWakeups.load();
+                result[m].yieldWakeups = member.yieldWakeups.load();
+                result[m].sleepWakeups = member.sleepWakeups.load();
+            }
+            return result;
+        }
+
+        void resetStats() {
+            for (int m = 0; m <= (int) members.size(); m++) {
+                Member &member = m == 0 ? caller : *members[m - 1];
+                member.idleNanoseconds.store(0);
+                member.jobs.store(0);
+                member.spinWakeups.store(0);
+                member.yieldWakeups.store(0);
+                member.sleepWakeups.store(0);
+            }
+        }
+};
+
+#endif //THREADTEAM_H
@@ -0,0 +1,283 @@
+//
+// Work-first parallel negamax. A thread always dives straight into the next child on its own board, the rest of the
+// move loop of every split node sits in its deque as a continuation. An idle thread steals the oldest continuation,
+// which is the one nearest the root, rebuilds that position on its own copy of the root board by replaying the moves
+// that lead to it, and takes moves from the same loop. So boards are only copied when work actually moves to another
+// thread, not once per child.
+// C++ has no way to resume another thread's stack frame, so a stolen continuation is the parent's remaining moves
+// rather than the frame itself, and the thread that opened the node still joins its result.
+//
+
+#ifndef WORKFIRSTSEARCH_H
+#define WORKFIRSTSEARCH_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <omp.h>
+
+#include "Engine.h"
+#include "WorkStealingDeque.h"
+
+template<int maxDepth>
+class WorkFirstSearch {
+    private:
+        using Line = std::array<Move, maxDepth>;
+
+        struct SplitPoint {
+            Color color;
+            int depth;
+            int ply;
+            int beta;
+            uint8_t moveCount;
+            //moves from the root to this node
+            Line path;
+            //next move of the loop to hand out
+            std::atomic<int> next{1};
+            //threads working here plus the deque holding it, the node returns once only its owner is left
+            std::atomic<int> references{2};
+            std::mutex lock;
+            int alpha;
+            int bestScore;
+            Line bestLine;
+        };
+
+        Engine engine;
+        StockDory::Board root;
+        std::vector<std::unique_ptr<WorkStealingDeque<SplitPoint *>>> deques;
+        std::atomic<bool> finished{false};
+        std::atomic<uint64_t> steals{0};
+        //nodes this close to the leaves are searched sequentially
+        int minSplitDepth = 2;
+        //a waiting thread runs stolen work on top of its own stack, this many levels at most, which bounds the stack
+        //of every thread to that many times the search depth
+        int maxNesting = 4;
+
+        static inline thread_local int worker = -1;
+        static inline thread_local int nesting = 0;
+        static inline thread_local uint64_t random = 0;
+
+        static void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+
+        template<Color color>
+        std::pair<Line, int> search(StockDory::Board &board, Line &path, int alpha, int beta, int depth, int ply) {
+            if (depth <= minSplitDepth) {
+                return engine.alphaBetaNega<color, maxDepth>(board, alpha, beta, depth, ply);
+            }
+            //mate distance pruning -> a mate found closer to the root cannot be beaten from here
+            if (ply > 0) {
+                alpha = std::max(alpha, -engine.mateScore + ply);
+                beta = std::min(beta, engine.mateScore - ply - 1);
+                if (alpha >= beta) {
+                    return std::make_pair(Line(), alpha);
+                }
+            }
+            const StockDory::SimplifiedMoveList<color> moveList(board);
+            //check for mate
+            if (moveList.Count() == 0 and board.Checked<color>()) {
+                return std::make_pair(Line(), -engine.mateScore + ply);
+            }
+            //stalemate
+            else if (moveList.Count() == 0) {
+                return std::make_pair(Line(), 0);
+            }
+
+            //eldest brother first and alone, on this thread's board
+            constexpr enum Color Ocolor = Opposite(color);
+            Move first = moveList[0];
+            path[ply] = first;
+            PreviousState prevState = board.Move<0>(first.From(), first.To(), first.Promotion());
+            std::pair<Line, int> result = search<Ocolor>(board, path, -beta, -alpha, depth - 1, ply + 1);
+            board.UndoMove<0>(prevState, first.From(), first.To());
+            result.second = -result.second;
+            Line bestLine;
+            bestLine[0] = first;
+            for (int j = 0; j < depth - 1; j++) {
+                bestLine[j + 1] = result.first[j];
+            }
+            alpha = std::max(alpha, result.second);
+            if (alpha >= beta or moveList.Count() == 1) {
+                return std::make_pair(bestLine, result.second);
+            }
+
+            //the rest of the loop becomes stealable while this thread keeps going
+            SplitPoint split;
+            split.color = color;
+            split.depth = depth;
+            split.ply = ply;
+            split.beta = beta;
+            split.moveCount = moveList.Count();
+            std::copy(path.begin(), path.begin() + ply, split.path.begin());
+            split.alpha = alpha;
+            split.bestScore = result.second;
+            split.bestLine = bestLine;
+            deques[worker]->push(&split);
+            work<color>(split, board, path, moveList);
+            //nobody stole the continuation -> take it back
+            SplitPoint *top;
+            if (deques[worker]->pop(top)) {
+                split.references.fetch_sub(1, std::memory_order_relaxed);
+            }
+            split.references.fetch_sub(1, std::memory_order_release);
+            waitUntil([&split] { return split.references.load(std::memory_order_acquire) == 0; });
+            return std::make_pair(split.bestLine, split.bestScore);
+        }
+
+        //hands out the moves of a split point one by one, on whatever board this thread has for it
+        template<Color color>
+        void work(SplitPoint &split, StockDory::Board &board, Line &path, const StockDory::SimplifiedMoveList<color> &moveList) {
+            constexpr enum Color Ocolor = Opposite(color);
+            while (true) {
+                int i = split.next.fetch_add(1, std::memory_order_relaxed);
+                if (i >= split.moveCount) {
+                    return;
+                }
+                int bound;
+                {
+                    std::lock_guard<std::mutex> guard(split.lock);
+                    bound = split.alpha;
+                }
+                if (bound >= split.beta) {
+                    return;
+                }
+                Move nextMove = moveList[i];
+                path[split.ply] = nextMove;
+                PreviousState prevState = board.Move<0>(nextMove.From(), nextMove.To(), nextMove.Promotion());
+                std::pair<Line, int> result = search<Ocolor>(board, path, -split.beta, -bound, split.depth - 1, split.ply + 1);
+                board.UndoMove<0>(prevState, nextMove.From(), nextMove.To());
+                result.second = -result.second;
+                std::lock_guard<std::mutex> guard(split.lock);
+                if (result.second > split.bestScore) {
+                    split.bestScore = result.second;
+                    split.bestLine[0] = nextMove;
+                    for (int j = 0; j < split.depth - 1; j++) {
+                        split.bestLine[j + 1] = result.first[j];
+                    }
+                    split.alpha = std::max(split.alpha, result.second);
+                    //cutoff -> no more moves for anybody
+                    if (split.alpha >= split.beta) {
+                        split.next.store(split.moveCount, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+
+        //the only place a board is copied: the thief rebuilds the split node from the root
+        template<Color color>
+        void join(SplitPoint &split) {
+            StockDory::Board board = root;
+            for (int i = 0; i < split.ply; i++) {
+                board.Move<0>(split.path[i].From(), split.path[i].To(), split.path[i].Promotion());
+            }
+            Line path = split.path;
+            const StockDory::SimplifiedMoveList<color> moveList(board);
+            work<color>(split, board, path, moveList);
+        }
+
+        //the reference of the deque it came from now belongs to this thread
+        void steal(SplitPoint &split) {
+            steals.fetch_add(1, std::memory_order_relaxed);
+            //what is left of the loop can be stolen again, from here
+            bool pushed = split.next.load(std::memory_order_relaxed) < split.moveCount;
+            if (pushed) {
+                split.references.fetch_add(1, std::memory_order_relaxed);
+                deques[worker]->push(&split);
+            }
+            if (split.color == White) {
+                join<White>(split);
+            }
+            else {
+                join<Black>(split);
+            }
+            SplitPoint *top;
+            if (pushed and deques[worker]->pop(top)) {
+                split.references.fetch_sub(1, std::memory_order_relaxed);
+            }
+            split.references.fetch_sub(1, std::memory_order_release);
+        }
+
+        bool trySteal() {
+            int count = deques.size();
+            for (int attempt = 1; attempt < count; attempt++) {
+                //xorshift, one stream per thread
+                random ^= random << 13;
+                random ^= random >> 7;
+                random ^= random << 17;
+                SplitPoint *split;
+                if (deques[(worker + 1 + random % (count - 1)) % count]->steal(split)) {
+                    steal(*split);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //steals while done() is false, backing off exponentially while there is nothing to steal
+        template<typename Done>
+        void waitUntil(Done done) {
+            int backoff = 1;
+            while (not done()) {
+                if (nesting < maxNesting) {
+                    nesting++;
+                    bool stolen = trySteal();
+                    nesting--;
+                    if (stolen) {
+                        backoff = 1;
+                        continue;
+                    }
+                }
+                if (backoff >= 1024) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (int i = 0; i < backoff; i++) {
+                    pause();
+                }
+                backoff *= 2;
+            }
+        }
+
+    public:
+        std::pair<Line, int> search(const StockDory::Board &chessBoard, int depth) {
+            root = chessBoard;
+            int threads = omp_get_max_threads();
+            deques.clear();
+            for (int i = 0; i < threads; i++) {
+                deques.push_back(std::make_unique<WorkStealingDeque<SplitPoint *>>());
+            }
+            finished.store(false);
+            steals.store(0);
+            std::pair<Line, int> result;
+            #pragma omp parallel num_threads(threads)
+            {
+                worker = omp_get_thread_num();
+                random = 0x9E3779B97F4A7C15ull * (worker + 1);
+                if (worker == 0) {
+                    StockDory::Board board = root;
+                    Line path;
+                    result = root.ColorToMove() == White ?
+                            search<White>(board, path, -50000, 50000, depth, 0) :
+                            search<Black>(board, path, -50000, 50000, depth, 0);
+                    finished.store(true, std::memory_order_release);
+                }
+                else {
+                    waitUntil([this] { return finished.load(std::memory_order_acquire); });
+                }
+                worker = -1;
+            }
+            return result;
+        }
+
+        //continuations taken by another thread in the last search, each one cost a board copy
+        uint64_t stealCount() const {
+            return steals.load();
+        }
+};
+
+#endif //WORKFIRSTSEARCH_H
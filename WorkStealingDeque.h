@@ -0,0 +1,295 @@
+//
+// Chase-Lev work-stealing deque and a scheduler built on it.
+// The owner pushes and pops at the bottom without locks, thieves take from the top and only race with the owner for
+// the last item. Every worker has its own deque, an idle worker steals from the others, so work spawned at any ply of
+// any search ends up wherever a thread is free.
+// Memory orders follow Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models".
+//
+
+#ifndef WORKSTEALINGDEQUE_H
+#define WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+template<typename T>
+class WorkStealingDeque {
+    private:
+        //circular buffer, indices only ever grow and wrap around the capacity
+        struct Array {
+            int64_t capacity;
+            std::unique_ptr<std::atomic<T>[]> items;
+
+            explicit Array(int64_t capacity) : capacity(capacity), items(new std::atomic<T>[capacity]) {}
+
+            T get(int64_t index) const {
+                return items[index & (capacity - 1)].load(std::memory_order_relaxed);
+            }
+
+            void put(int64_t index, T item) {
+                items[index & (capacity - 1)].store(item, std::memory_order_relaxed);
+            }
+        };
+
+        alignas(64) std::atomic<int64_t> top{0};
+        alignas(64) std::atomic<int64_t> bottom{0};
+        std::atomic<Array *> array;
+        //a thief may still read an old buffer after a grow, they are only freed with the deque
+        std::vector<std::unique_ptr<Array>> buffers;
+
+        Array *grow(Array *old, int64_t b, int64_t t) {
+            buffers.push_back(std::make_unique<Array>(old->capacity * 2));
+            Array *bigger = buffers.back().get();
+            for (int64_t i = t; i < b; i++) {
+                bigger->put(i, old->get(i));
+            }
+            array.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+
+    public:
+        //capacity has to be a power of two, the deque doubles it whenever it is full
+        explicit WorkStealingDeque(int64_t capacity = 256) {
+            buffers.push_back(std::make_unique<Array>(capacity));
+            array.store(buffers.back().get(), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque &) = delete;
+        WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+        //owner only
+        void push(T item) {
+            int64_t b = bottom.load(std::memory_order_relaxed);
+            int64_t t = top.load(std::memory_order_acquire);
+            Array *a = array.load(std::memory_order_relaxed);
+            if (b - t > a->capacity - 1) {
+                a = grow(a, b, t);
+            }
+            a->put(b, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        //owner only, newest item first
+        bool pop(T &item) {
+            int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            Array *a = array.load(std::memory_order_relaxed);
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top.load(std::memory_order_relaxed);
+            if (t > b) {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            item = a->get(b);
+            if (t == b) {
+                //last item -> whoever moves top first gets it
+                bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        //any thread, oldest item first -> near the root of whatever the owner is searching, the biggest pieces of work
+        bool steal(T &item) {
+            int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = bottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return false;
+            }
+            Array *a = array.load(std::memory_order_acquire);
+            item = a->get(t);
+            return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        bool empty() const {
+            return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+        }
+};
+
+//tasks spawned into a group can be waited for together
+struct TaskGroup {
+    std::atomic<int> pending{0};
+};
+
+//a team of workers, one deque each. Tasks spawn more tasks and wait for their groups, a worker that waits runs its own
+//tasks first and steals when it has none, so no thread sits idle while there is work anywhere.
+class WorkStealingScheduler {
+    public:
+        struct Config {
+            //0 takes the OpenMP default
+            int threads = 0;
+            //false -> victims are tried in order starting after the thief, which is cheaper but makes thieves collide
+            bool randomVictims = true;
+            //failed steal rounds first spin this many pauses, doubling up to maxBackoff, after that the thread yields
+            int minBackoff = 1;
+            int maxBackoff = 1024;
+            //a waiting thread runs stolen tasks on top of its own stack, this many levels at most, which bounds the stack
+            //of every thread to that many times the depth of the task tree. Its own tasks it always runs.
+            int maxNesting = 4;
+        };
+
+    private:
+        struct Task {
+            TaskGroup *group;
+
+            explicit Task(TaskGroup *group) : group(group) {}
+            virtual ~Task() = default;
+            virtual void run() = 0;
+        };
+
+        template<typename F>
+        struct FunctionTask : Task {
+            F function;
+
+            FunctionTask(TaskGroup *group, F &&function) : Task(group), function(std::move(function)) {}
+
+            void run() override {
+                function();
+            }
+        };
+
+        Config config;
+        std::vector<std::unique_ptr<WorkStealingDeque<Task *>>> deques;
+        std::atomic<bool> finished{false};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<uint64_t> failedSteals{0};
+
+        //deque of the calling thread, -1 outside of run
+        static inline thread_local int worker = -1;
+        //stolen tasks currently on the stack of this thread
+        static inline thread_local int nesting = 0;
+        static inline thread_local uint64_t random = 0;
+
+        static void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+
+        int victim(int attempt) {
+            int count = deques.size();
+            if (config.randomVictims) {
+                //xorshift, one stream per thread
+                random ^= random << 13;
+                random ^= random >> 7;
+                random ^= random << 17;
+                return (worker + 1 + random % (count - 1)) % count;
+            }
+            return (worker + 1 + attempt % (count - 1)) % count;
+        }
+
+        static void execute(Task *task) {
+            TaskGroup *group = task->group;
+            task->run();
+            delete task;
+            group->pending.fetch_sub(1, std::memory_order_release);
+        }
+
+        //one task from anywhere, own deque first. At the nesting limit only the own deque.
+        bool runOne() {
+            Task *task;
+            if (deques[worker]->pop(task)) {
+                execute(task);
+                return true;
+            }
+            if (nesting >= config.maxNesting) {
+                return false;
+            }
+            for (size_t attempt = 0; attempt + 1 < deques.size(); attempt++) {
+                if (deques[victim(attempt)]->steal(task)) {
+                    steals.fetch_add(1, std::memory_order_relaxed);
+                    nesting++;
+                    execute(task);
+                    nesting--;
+                    return true;
+                }
+            }
+            if (deques.size() > 1) {
+                failedSteals.fetch_add(1, std::memory_order_relaxed);
+            }
+            return false;
+        }
+
+        //run tasks while done() is false, backing off while there is nothing to run
+        template<typename Done>
+        void workUntil(Done done) {
+            int backoff = config.minBackoff;
+            while (not done()) {
+                if (runOne()) {
+                    backoff = config.minBackoff;
+                    continue;
+                }
+                if (backoff >= config.maxBackoff) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (int i = 0; i < backoff; i++) {
+                    pause();
+                }
+                backoff *= 2;
+            }
+        }
+
+    public:
+        WorkStealingScheduler() = default;
+        explicit WorkStealingScheduler(const Config &config) : config(config) {}
+
+        //root runs on the calling thread as worker 0, the other workers steal until it returns
+        template<typename F>
+        void run(F root) {
+            int threads = config.threads > 0 ? config.threads : omp_get_max_threads();
+            deques.clear();
+            for (int i = 0; i < threads; i++) {
+                deques.push_back(std::make_unique<WorkStealingDeque<Task *>>());
+            }
+            finished.store(false);
+            #pragma omp parallel num_threads(threads)
+            {
+                worker = omp_get_thread_num();
+                random = 0x9E3779B97F4A7C15ull * (worker + 1);
+                if (worker == 0) {
+                    root();
+                    finished.store(true, std::memory_order_release);
+                }
+                else {
+                    workUntil([this] { return finished.load(std::memory_order_acquire); });
+                }
+                worker = -1;
+            }
+        }
+
+        //only from inside run, the task may run on any worker
+        template<typename F>
+        void spawn(TaskGroup &group, F function) {
+            group.pending.fetch_add(1, std::memory_order_relaxed);
+            deques[worker]->push(new FunctionTask<F>(&group, std::move(function)));
+        }
+
+        //helps with any work there is until every task of the group is done, stealing only below the nesting limit
+        void wait(TaskGroup &group) {
+            workUntil([&group] { return group.pending.load(std::memory_order_acquire) == 0; });
+        }
+
+        //number of workers in the last run
+        int workers() const {
+            return deques.size();
+        }
+
+        uint64_t stealCount() const {
+            return steals.load();
+        }
+
+        uint64_t failedStealCount() const {
+            return failedSteals.load();
+        }
+};
+
+#endif //WORKSTEALINGDEQUE_H
@@ -0,0 +1,198 @@
+// analysis.cpp
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdlib> // For std::atoi
+#include "Backend/Board.h"
+#include "Backend/Type/Square.h"
+#include "BatchAnalysis.h"
+#include "GameAnalysis.h"
+#include "MateSuites.h"
+#include <omp.h>
+
+constexpr int maxDepth = 25;
+
+// Function to convert a Square enum to its string representation (e.g., E2 -> "e2")
+std::string squareToString(Square square) {
+    return std::string(1, File(square)) + std::string(1, Rank(square));
+}
+
+// Function to display usage instructions
+void printUsage(const std::string &programName) {
+    std::cerr << "Usage: " << programName << " batch <depth> [fen-file] [threads-per-position]\n";
+    std::cerr << "  <depth>              : Positive integer specifying the search depth.\n";
+    std::cerr << "  [fen-file]           : One FEN per line, '-' reads standard input. Defaults to the mate in 3 and mate in 4 suites.\n";
+    std::cerr << "  [threads-per-position] : 1 runs one sequential search per core, more runs a small parallel search per core group.\n";
+    std::cerr << "       " << programName << " game <depth> [--fen <fen>] <move>...\n";
+    std::cerr << "  <move>               : Moves of the game in coordinate notation (e2e4, e7e8q).\n";
+    std::cerr << "       " << programName << " check\n";
+    std::cerr << "  check                : Plays the engine's own best moves and checks each one scores as much as the best.\n";
+    std::cerr << "Example:\n";
+    std::cerr << "  " << programName << " batch 5 puzzles.txt\n";
+    std::cerr << "  " << programName << " game 5 e2e4 e7e5 g1f3 b8c6 f1b5\n";
+}
+
+// Function to list the mate in 3 and mate in 4 suites that main.cpp and m4.cpp search
+std::vector<std::string> mateSuites() {
+    std::vector<std::string> fens(std::begin(mateIn3FENs), std::end(mateIn3FENs));
+    fens.insert(fens.end(), std::begin(mateIn4FENs), std::end(mateIn4FENs));
+    return fens;
+}
+
+// Function to check that the played score and the best score of a move come from the same search: no played move beats
+// the best one, and where the played move is the best move the two scores are equal
+int checkPlayedScores() {
+    const int depth = 4;
+    const std::vector<std::string> starts = {
+        StockDory::Board().Fen(),
+        "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+        "8/8/8/8/k7/4Q3/3K4/8 w - - 0 1",
+    };
+    bool ok = true;
+    int bestPlayed = 0;
+    for (const std::string &start : starts) {
+        // Each move is the best move an analysis of the game so far found for its position, later positions can change
+        // that in the analysis of the whole game
+        std::vector<std::string> moves;
+        for (int ply = 0; ply < 4; ply++) {
+            StockDory::Board board(start);
+            for (const std::string &move : moves) {
+                Move parsed = Move::FromString(move);
+                board.Move<ZOBRIST>(parsed.From(), parsed.To(), parsed.Promotion());
+            }
+            GameAnalysis<maxDepth> probe;
+            std::string any = board.ColorToMove() == White ?
+                    StockDory::SimplifiedMoveList<White>(board)[0].ToString() : StockDory::SimplifiedMoveList<Black>(board)[0].ToString();
+            std::vector<std::string> tried = moves;
+            tried.push_back(any);
+            moves.push_back(probe.analyze(start, tried, depth).back().bestLine[0].ToString());
+        }
+
+        GameAnalysis<maxDepth> game;
+        std::vector<GameAnalysis<maxDepth>::Result> results = game.analyze(start, moves, depth);
+        for (const GameAnalysis<maxDepth>::Result &result : results) {
+            bool isBest = result.played == result.bestLine[0];
+            bestPlayed += isBest;
+            if (result.playedScore > result.bestScore || (isBest && result.playedScore != result.bestScore)) {
+                std::cerr << result.fen << ": " << result.played.ToString() << " played " << result.playedScore
+                          << ", best " << result.bestLine[0].ToString() << " " << result.bestScore << "\n";
+                ok = false;
+            }
+        }
+    }
+    // The check means nothing if no game kept a single best move
+    if (bestPlayed == 0) {
+        std::cerr << "No played move was the best move\n";
+        ok = false;
+    }
+    std::cout << "Played scores: " << (ok ? "OK" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "";
+
+    if (mode == "check" && argc == 2) {
+        return checkPlayedScores();
+    }
+
+    if (mode == "batch" && argc >= 3 && argc <= 5) {
+        int depth = std::atoi(argv[2]);
+        if (depth <= 0) {
+            std::cerr << "Invalid depth: " << depth << ". Depth must be a positive integer.\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+        int threadsPerPosition = argc == 5 ? std::atoi(argv[4]) : 1;
+
+        std::vector<std::string> fens;
+        if (argc >= 4) {
+            std::string path = argv[3];
+            std::ifstream file;
+            if (path != "-") {
+                file.open(path);
+                if (!file.is_open()) {
+                    std::cerr << "Error: Unable to open " << path << " for reading\n";
+                    return 1;
+                }
+            }
+            std::istream &input = path == "-" ? std::cin : file;
+            std::string line;
+            while (std::getline(input, line)) {
+                if (!line.empty()) {
+                    fens.push_back(line);
+                }
+            }
+        }
+        else {
+            fens = mateSuites();
+        }
+
+        std::cout << "Positions: " << fens.size() << ", threads: " << omp_get_max_threads()
+                  << ", threads per position: " << threadsPerPosition << "\n";
+        BatchAnalysis<maxDepth> batch;
+        double tstart = omp_get_wtime();
+        batch.analyze(fens, depth, threadsPerPosition, [depth](const BatchAnalysis<maxDepth>::Result &result) {
+            Move bestMove = result.bestLine.front();
+            std::cout << result.index << ": " << result.fen << " | "
+                      << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                      << " with score " << result.score << " | line: ";
+            for (int i = 0; i < depth; i++) {
+                Move move = result.bestLine[i];
+                std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+            }
+            std::cout << "| " << result.seconds << "s" << std::endl;
+        });
+        double ttaken = omp_get_wtime() - tstart;
+        printf("Time taken for batch: %f (%f positions per second)\n", ttaken, fens.size() / ttaken);
+        return 0;
+    }
+
+    if (mode == "game" && argc >= 4) {
+        int depth = std::atoi(argv[2]);
+        if (depth <= 0) {
+            std::cerr << "Invalid depth: " << depth << ". Depth must be a positive integer.\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+        int first = 3;
+        std::string startFen = StockDory::Board().Fen();
+        if (std::string(argv[3]) == "--fen" && argc >= 6) {
+            startFen = argv[4];
+            first = 5;
+        }
+        std::vector<std::string> moves(argv + first, argv + argc);
+
+        GameAnalysis<maxDepth> game;
+        std::vector<GameAnalysis<maxDepth>::Result> results;
+        double tstart = omp_get_wtime();
+        try {
+            results = game.analyze(startFen, moves, depth);
+        }
+        catch (const std::invalid_argument &error) {
+            std::cerr << "Error: " << error.what() << "\n";
+            return 1;
+        }
+        double ttaken = omp_get_wtime() - tstart;
+
+        // Move numbers start from the side to move in the start position
+        size_t blackFirst = StockDory::Board(startFen).ColorToMove() == Black ? 1 : 0;
+        for (size_t i = 0; i < results.size(); i++) {
+            const GameAnalysis<maxDepth>::Result &result = results[i];
+            size_t ply = i + blackFirst;
+            std::cout << (ply / 2 + 1) << (ply % 2 == 0 ? ". " : "... ") << result.played.ToString()
+                      << " | played " << result.playedScore << ", best " << result.bestScore << " | line: ";
+            for (int j = 0; j < depth; j++) {
+                Move move = result.bestLine[j];
+                std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+            }
+            std::cout << "\n";
+        }
+        printf("Time taken for game: %f\n", ttaken);
+        return 0;
+    }
+
+    printUsage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,295 @@
+// cluster.cpp
+#include <iostream>
+#include <string>
+#include <vector>
+#include <array>
+#include <cstdlib> // For std::atoi
+#include <csignal>
+#include <sys/wait.h>
+#include "Backend/Board.h"
+#include "Backend/Type/Square.h"
+#include "ClusterSearch.h"
+#include <omp.h>
+
+constexpr int maxDepth = 25;
+
+// Function to convert a Square enum to its string representation (e.g., E2 -> "e2")
+std::string squareToString(Square square) {
+    return std::string(1, File(square)) + std::string(1, Rank(square));
+}
+
+// Function to display usage instructions
+void printUsage(const std::string &programName) {
+    std::cerr << "Usage: " << programName << " worker <address> [--tds <address>...]\n";
+    std::cerr << "       " << programName << " coordinator <depth> <fen> <address>... [--tds]\n";
+    std::cerr << "       " << programName << " local <depth> <workers> [fen] [--tds]\n";
+    std::cerr << "       " << programName << " check\n";
+    std::cerr << "       " << programName << " check-tds\n";
+    std::cerr << "  <address> : Unix socket path (/tmp/worker0.sock) or host:port (127.0.0.1:9000).\n";
+    std::cerr << "  local     : Starts <workers> worker processes on this machine and coordinates them.\n";
+    std::cerr << "  --tds     : Transposition-driven scheduling, each worker holds one shard of the table and searches the positions\n";
+    std::cerr << "              that hash to it. A worker is given every address of the cluster in the coordinator's order.\n";
+    std::cerr << "  check     : Sends a request and a reply through a socket pair and checks they arrive unchanged.\n";
+    std::cerr << "  check-tds : Searches a few positions with local transposition-driven workers and compares with alpha-beta.\n";
+    std::cerr << "Example:\n";
+    std::cerr << "  " << programName << " local 6 4\n";
+}
+
+// Function to start worker processes on this machine, each listening on its own Unix socket
+void startWorkers(int workerCount, bool transpositionDriven, std::vector<std::string> &addresses, std::vector<pid_t> &workers) {
+    // Sockets are bound before forking so the coordinator can connect without waiting for the workers,
+    // and every worker knows the addresses of all the others
+    std::vector<int> listenFds;
+    for (int w = 0; w < workerCount; w++) {
+        std::string address = "/tmp/multicorechess-" + std::to_string(getpid()) + "-" + std::to_string(w) + ".sock";
+        int listenFd = ClusterSearch<maxDepth>::listenOn(address);
+        if (listenFd < 0) {
+            std::cerr << "Error: Unable to listen on " << address << "\n";
+            continue;
+        }
+        addresses.push_back(address);
+        listenFds.push_back(listenFd);
+    }
+    for (size_t w = 0; w < listenFds.size(); w++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            ClusterSearch<maxDepth> worker;
+            if (transpositionDriven) {
+                worker.setShards(addresses);
+            }
+            worker.serve(listenFds[w], true);
+            _exit(0);
+        }
+        workers.push_back(pid);
+    }
+    for (int listenFd : listenFds) {
+        close(listenFd);
+    }
+}
+
+// Function to wait for the workers once the coordinator has closed its connections, which ends them
+void stopWorkers(const std::vector<std::string> &addresses, const std::vector<pid_t> &workers) {
+    for (pid_t pid : workers) {
+        if (pid > 0) {
+            waitpid(pid, nullptr, 0);
+        }
+    }
+    for (const std::string &address : addresses) {
+        unlink(address.c_str());
+    }
+}
+
+// Function to run the coordinator and print the result
+int coordinate(ClusterSearch<maxDepth> &cluster, const StockDory::Board &chessBoard, int depth, bool transpositionDriven) {
+    double tstart = omp_get_wtime();
+    std::pair<std::array<Move, maxDepth>, int> result;
+    if (transpositionDriven) {
+        result = chessBoard.ColorToMove() == White ?
+                cluster.transpositionDriven<White>(chessBoard, depth) :
+                cluster.transpositionDriven<Black>(chessBoard, depth);
+    }
+    else {
+        result = chessBoard.ColorToMove() == White ?
+                cluster.search<White>(chessBoard, depth) :
+                cluster.search<Black>(chessBoard, depth);
+    }
+    double ttaken = omp_get_wtime() - tstart;
+    printf("Time taken for main part: %f\n", ttaken);
+
+    Move bestMove = result.first.front();
+    std::cout << "Best Move (Cluster): " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+              << " with score " << result.second << "\n";
+    std::cout << "Best Line: ";
+    for (int i = 0; i < depth; i++) {
+        Move move = result.first[i];
+        std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+    }
+    std::cout << "\n";
+    return 0;
+}
+
+// Function to check the wire format: the header bytes are fixed, and a request and a reply survive a round trip
+int checkEncoding() {
+    bool ok = true;
+
+    // Big-endian fields without padding, whatever the host
+    SearchRequest request = {-2, 50000, 7, -1, 56};
+    std::array<uint8_t, SearchRequest::Size> header;
+    request.Encode(header.data());
+    const std::array<uint8_t, SearchRequest::Size> expected = {0xFF, 0xFF, 0xFF, 0xFE, 0x00, 0x00, 0xC3, 0x50, 0x00, 0x07, 0xFF, 0xFF, 0x00, 0x38};
+    if (header != expected) {
+        std::cerr << "Request header has the wrong layout\n";
+        ok = false;
+    }
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        std::cerr << "Error: Unable to create a socket pair\n";
+        return 1;
+    }
+
+    StockDory::Board chessBoard("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    SearchRequest received;
+    std::string fen;
+    if (!ClusterSearch<maxDepth>::sendRequest(fds[0], chessBoard, -50000, -123, 5, 3) ||
+        !ClusterSearch<maxDepth>::receiveRequest(fds[1], received, fen) ||
+        received.Alpha != -50000 || received.Beta != -123 || received.Depth != 5 || received.Ply != 3 || fen != chessBoard.Fen()) {
+        std::cerr << "Request changed on the way\n";
+        ok = false;
+    }
+
+    std::pair<std::array<Move, maxDepth>, int> sent;
+    sent.first[0] = Move::FromString("e5f7");
+    sent.first[1] = Move::FromString("e8g8");
+    sent.first[2] = Move::FromString("d5d6");
+    sent.first[3] = Move::FromString("b4b3");
+    sent.second = -19997;
+    std::pair<std::array<Move, maxDepth>, int> reply;
+    if (!ClusterSearch<maxDepth>::sendReply(fds[1], sent, 3) ||
+        !ClusterSearch<maxDepth>::receiveReply(fds[0], reply) ||
+        reply.second != sent.second || !(reply.first[0] == sent.first[0]) || !(reply.first[1] == sent.first[1]) ||
+        !(reply.first[2] == sent.first[2]) || !(reply.first[3] == Move())) {
+        std::cerr << "Reply changed on the way\n";
+        ok = false;
+    }
+
+    // A promotion uses the top bits of a packed move
+    sent.first[0] = Move::FromString("a7a8q");
+    if (!ClusterSearch<maxDepth>::sendReply(fds[1], sent, 1) ||
+        !ClusterSearch<maxDepth>::receiveReply(fds[0], reply) || !(reply.first[0] == sent.first[0])) {
+        std::cerr << "Promotion changed on the way\n";
+        ok = false;
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+    std::cout << "Wire encoding: " << (ok ? "OK" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
+
+// Function to check transposition-driven search against a plain alpha-beta search of the same depth
+int checkTranspositionDriven() {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "7k/8/3NK3/5BN1/8/8/8/8 w - - 0 1",
+        "8/8/2K5/7r/6r1/8/6k1/8 b - - 0 1",
+    };
+    std::vector<std::string> addresses;
+    std::vector<pid_t> workers;
+    startWorkers(3, true, addresses, workers);
+
+    bool ok = true;
+    {
+        ClusterSearch<maxDepth> cluster;
+        cluster.setShards(addresses);
+        for (const std::string &address : addresses) {
+            cluster.addWorker(address);
+        }
+        Engine engine;
+        for (const char* fen : fens) {
+            StockDory::Board chessBoard(fen);
+            int depth = 5;
+            int expected = chessBoard.ColorToMove() == White ?
+                    engine.alphaBetaNega<White, maxDepth>(chessBoard, -50000, 50000, depth).second :
+                    engine.alphaBetaNega<Black, maxDepth>(chessBoard, -50000, 50000, depth).second;
+            int score = chessBoard.ColorToMove() == White ?
+                    cluster.transpositionDriven<White>(chessBoard, depth).second :
+                    cluster.transpositionDriven<Black>(chessBoard, depth).second;
+            if (score != expected) {
+                std::cerr << fen << ": transposition-driven " << score << ", alpha-beta " << expected << "\n";
+                ok = false;
+            }
+        }
+    }
+    stopWorkers(addresses, workers);
+    std::cout << "Transposition-driven search: " << (ok ? "OK" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    // A worker that goes away must not kill the coordinator while it writes to it
+    signal(SIGPIPE, SIG_IGN);
+
+    // Everything after --tds is the shard list of a worker, a coordinator takes its own worker list
+    int tds = 1;
+    while (tds < argc && std::string(argv[tds]) != "--tds") {
+        tds++;
+    }
+    bool transpositionDriven = tds < argc;
+    std::vector<std::string> shards(argv + std::min(tds + 1, argc), argv + argc);
+    argc = tds;
+    std::string mode = argc > 1 ? argv[1] : "";
+
+    if (mode == "check" && argc == 2 && !transpositionDriven) {
+        return checkEncoding();
+    }
+
+    if (mode == "check-tds" && argc == 2 && !transpositionDriven) {
+        return checkTranspositionDriven();
+    }
+
+    if (mode == "worker" && argc == 3 && (!transpositionDriven || !shards.empty())) {
+        int listenFd = ClusterSearch<maxDepth>::listenOn(argv[2]);
+        if (listenFd < 0) {
+            std::cerr << "Error: Unable to listen on " << argv[2] << "\n";
+            return 1;
+        }
+        ClusterSearch<maxDepth> worker;
+        if (transpositionDriven) {
+            worker.setShards(shards);
+        }
+        worker.serve(listenFd);
+        return 0;
+    }
+
+    if (mode == "coordinator" && argc >= 5 && shards.empty()) {
+        int depth = std::atoi(argv[2]);
+        if (depth <= 0) {
+            std::cerr << "Invalid depth: " << depth << ". Depth must be a positive integer.\n";
+            return 1;
+        }
+        StockDory::Board chessBoard(argv[3]);
+        ClusterSearch<maxDepth> cluster;
+        if (transpositionDriven) {
+            cluster.setShards(std::vector<std::string>(argv + 4, argv + argc));
+        }
+        for (int i = 4; i < argc; i++) {
+            if (!cluster.addWorker(argv[i])) {
+                std::cerr << "Warning: Unable to reach worker " << argv[i] << "\n";
+            }
+        }
+        return coordinate(cluster, chessBoard, depth, transpositionDriven);
+    }
+
+    if (mode == "local" && (argc == 4 || argc == 5) && shards.empty()) {
+        int depth = std::atoi(argv[2]);
+        int workerCount = std::atoi(argv[3]);
+        if (depth <= 0 || workerCount <= 0) {
+            std::cerr << "Invalid depth or worker count. Both must be positive integers.\n";
+            return 1;
+        }
+        StockDory::Board chessBoard = argc == 5 ? StockDory::Board(argv[4]) : StockDory::Board();
+
+        std::vector<std::string> addresses;
+        std::vector<pid_t> workers;
+        startWorkers(workerCount, transpositionDriven, addresses, workers);
+
+        int status;
+        {
+            ClusterSearch<maxDepth> cluster;
+            if (transpositionDriven) {
+                cluster.setShards(addresses);
+            }
+            for (const std::string &address : addresses) {
+                cluster.addWorker(address);
+            }
+            std::cout << "Workers: " << addresses.size() << "\n";
+            status = coordinate(cluster, chessBoard, depth, transpositionDriven);
+        }
+        stopWorkers(addresses, workers);
+        return status;
+    }
+
+    printUsage(argv[0]);
+    return 1;
+}
@@ -8,11 +8,18 @@
 #include "SimplifiedMoveList.h"
 #include "Backend/Type/Color.h"
 #include "Engine.h"
+#include "APHID.h"
+#include "MCTS.h"
+#include "ProofNumberSearch.h"
+#include "Affinity.h"
+#include "MateSuites.h"
 #include <omp.h>
 #include <fstream> // For file I/O
 #include <iomanip> // For formatting output
 
 constexpr int maxDepth = 25;
+// MCTS playouts per ply of the requested depth
+constexpr int mctsPlayouts = 10000;
 
 // Function to convert a Square enum to its string representation (e.g., E2 -> "e2")
 std::string squareToString(Square square) {
@@ -21,12 +28,21 @@ std::string squareToString(Square square) {
 
 // Function to display usage instructions
 void printUsage(const std::string &programName) {
-    std::cerr << "Usage: " << programName << " <depth>\n";
+    std::cerr << "Usage: " << programName << " <depth> [pin]\n";
     std::cerr << "  <depth> : Positive integer specifying the search depth.\n";
+    std::cerr << "  pin     : Pin search threads to physical cores first and SMT siblings last.\n";
     std::cerr << "Example:\n";
     std::cerr << "  " << programName << " 4\n";
 }
 
+// Function to set the number of search threads, and place them when pinning is on
+void setSearchThreads(int threads) {
+    omp_set_num_threads(threads);
+    if (Affinity::enabled()) {
+        Affinity::pinOpenMPThreads(threads);
+    }
+}
+
 // Function to display the algorithm options list
 void displayAlgorithmOptions() {
     std::cout << "Choose Search Algorithm:\n";
@@ -38,11 +54,19 @@ void displayAlgorithmOptions() {
 
 int main(int argc, char* argv[]) {
     // Check if the depth argument is provided
-    if (argc != 2) {
+    if (argc != 2 && argc != 3) {
         std::cerr << "Error: Incorrect number of arguments.\n";
         printUsage(argv[0]);
         return 1;
     }
+    if (argc == 3) {
+        if (std::string(argv[2]) != "pin") {
+            std::cerr << "Unknown option: " << argv[2] << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+        Affinity::enable(true);
+    }
 
     // Parse the depth from the first command-line argument
     int depth = std::atoi(argv[1]);
@@ -236,26 +260,54 @@ int main(int argc, char* argv[]) {
         }
     }
     else if (algorithmChoice == 3) {
-        const char* mateIn4FENs[] = { //Mate in 4
-            "8/8/5k2/R7/7R/8/8/5K2 w - - 0 1",
-            "8/8/5k2/7Q/R7/8/8/5K2 w - - 0 1",
-            "3k4/8/5K2/5R2/4B3/8/8/8 w - - 0 1",
-            "3k4/3N3P/8/3K4/8/8/8/8 w - - 0 1",
-            "8/8/8/3k4/1nnn1n2/8/8/2K5 b - - 1 1",
-            "8/8/8/2bk4/2bbb3/8/8/2K5 b - - 1 1",
-            "8/8/8/2nk4/2bbn3/8/8/2K5 b - - 1 1",
-            "8/8/8/8/8/1rkB4/3N1r2/3K4 b - - 1 1",
-        };
         std::ofstream resultFile("results.txt");
         if (!resultFile.is_open()) {
             std::cerr << "Error: Unable to open results.txt for writing\n";
             return 0;
         }
         std::cout << "Testing mate in 4 FENs\n";
+        ProofNumberSearch<maxDepth> mateSolver;
         for (const char* fen : mateIn4FENs) {
             StockDory::Board chessBoard(fen);
             resultFile << "Current Fen: " << fen << "\n";
             std::cout << "Current Fen: " << fen << "\n" << std::endl;
+
+            // Proof-number search proves the mate without a fixed depth
+            tstart = omp_get_wtime();
+            ProofNumberSearch<maxDepth>::Result mate = mateSolver.solve(chessBoard, 4);
+            tend = omp_get_wtime();
+            ttaken = tend - tstart;
+            printf("Time taken for proof-number search: %f\n", ttaken);
+            if (mate.mate) {
+                std::cout << "Mate in " << mate.moves << " found with " << mate.nodes << " nodes: ";
+                for (int i = 0; i < 2 * mate.moves - 1; i++) {
+                    Move move = mate.line[i];
+                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                }
+                std::cout << "\n";
+            } else {
+                std::cout << "No mate in 4 (" << mate.nodes << " nodes)\n";
+            }
+            resultFile << "Proof number nodes: " << mate.nodes << "\n";
+            resultFile << "Proof Number Search,1," << ttaken << "\n";
+
+            // Same proof with the threads sharing one proof table
+            int mateThreads[] = {2, 4, 8, 16, 32, 64};
+            for (int threads : mateThreads) {
+                std::cout << "Algorithm: Parallel Proof Number Search\n" << std::endl;
+                std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                tstart = omp_get_wtime();
+                ProofNumberSearch<maxDepth>::Result parallelMate = mateSolver.solve(chessBoard, 4, threads);
+                tend = omp_get_wtime();
+                ttaken = tend - tstart;
+                printf("Time taken for parallel proof-number search: %f\n", ttaken);
+                if (parallelMate.mate) {
+                    std::cout << "Mate in " << parallelMate.moves << " found with " << parallelMate.nodes << " nodes\n";
+                } else {
+                    std::cout << "No mate in 4 (" << parallelMate.nodes << " nodes)\n";
+                }
+                resultFile << "Parallel Proof Number Search," << threads << "," << ttaken << "\n";
+            }
             for (int depth = 7; depth < 9; depth++) {
                 std::cout << "Testing depth: " << depth << "\n";
                 if (chessBoard.ColorToMove() == White) {
@@ -362,8 +414,15 @@ int main(int argc, char* argv[]) {
 
                 int numThreads[] = {1, 2, 4, 8, 16, 32, 64};
 
+                //where each thread count runs, so the curves can be reproduced
+                for (int threads : numThreads) {
+                    std::string placement = Affinity::enabled() ? Affinity::describe(threads) : "not pinned";
+                    std::cout << "Placement for " << threads << " threads: " << placement << "\n";
+                    resultFile << "Placement," << threads << ",\"" << placement << "\"\n";
+                }
+
                 for (int threads : numThreads) {
-                    omp_set_num_threads(threads);
+                    setSearchThreads(threads);
                     std::cout << "Algorithm: Parallel Minimax\n" << std::endl;
                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;
                     totalTime = 0;
@@ -495,7 +554,7 @@ int main(int argc, char* argv[]) {
                 resultFile << "Sequential AlphaBeta,1," << averageTime << "\n";
 
                 for (int threads : numThreads) {
-                    omp_set_num_threads(threads);
+                    setSearchThreads(threads);
                     std::cout << "Algorithm: Naive Alpha Beta Parallel\n" << std::endl;
 
                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;
@@ -566,7 +625,7 @@ int main(int argc, char* argv[]) {
                 }
 
                 for (int threads : numThreads) {
-                    omp_set_num_threads(threads);
+                    setSearchThreads(threads);
                     std::cout << "Algorithm: Naive Alpha Beta Parallel\n" << std::endl;
 
                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;
@@ -637,7 +696,7 @@ int main(int argc, char* argv[]) {
                 }
 
                 for (int threads : numThreads) {
-                    omp_set_num_threads(threads);
+                    setSearchThreads(threads);
                     std::cout << "Algorithm: YBWC\n" << std::endl;
 
                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;
@@ -708,7 +767,291 @@ int main(int argc, char* argv[]) {
                 }
 
                 for (int threads : numThreads) {
-                    omp_set_num_threads(threads);
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: Work Stealing YBWC\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 5; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.stealingYBWC<White, maxDepth>(
+                                chessBoard,
+                                -50000,
+                                50000,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part work stealing YBWC: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.stealingYBWC<Black, maxDepth>(
+                                chessBoard,
+                                -50000,
+                                50000,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part work stealing YBWC: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/5;
+                    std::cout << "Average time for YBWC in 5 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "Work Stealing YBWC," << threads << "," << averageTime << "\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: Team YBWC\n" << std::endl;
+                    ThreadTeam::shared().resetStats();
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 5; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.teamYBWC<White, maxDepth>(
+                                chessBoard,
+                                -50000,
+                                50000,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part team YBWC: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.teamYBWC<Black, maxDepth>(
+                                chessBoard,
+                                -50000,
+                                50000,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part team YBWC: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/5;
+                    std::cout << "Average time for YBWC in 5 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "Team YBWC," << threads << "," << averageTime << "\n";
+                    //time the caller and the members spent waiting for work, and how awake they were when it came
+                    std::vector<ThreadTeam::Stats> teamStats = ThreadTeam::shared().stats();
+                    for (size_t member = 0; member < teamStats.size(); member++) {
+                        std::cout << (member == 0 ? "Team caller" : "Team member " + std::to_string(member)) << " idle " << teamStats[member].idleSeconds << "s, jobs " << teamStats[member].jobs
+                                  << " (woken spinning " << teamStats[member].spinWakeups << ", yielding " << teamStats[member].yieldWakeups
+                                  << ", sleeping " << teamStats[member].sleepWakeups << ")\n";
+                    }
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: Iterative Naive Alpha Beta Parallel\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 5; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.iterativeNaiveParallelAlphaBeta<White, maxDepth>(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part iterative naive alpha beta parallel: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.iterativeNaiveParallelAlphaBeta<Black, maxDepth>(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part iterative naive alpha beta parallel: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/5;
+                    std::cout << "Average time for YBWC in 5 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "Iterative Naive Parallel Alpha Beta," << threads << "," << averageTime << "\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: Iterative YBWC\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 5; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.iterativeYBWC<White, maxDepth>(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part iterative YBWC: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.iterativeYBWC<Black, maxDepth>(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part iterative YBWC: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/5;
+                    std::cout << "Average time for YBWC in 5 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "Iterative YBWC," << threads << "," << averageTime << "\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
                     std::cout << "Algorithm: PVS\n" << std::endl;
 
                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;
@@ -777,6 +1120,284 @@ int main(int argc, char* argv[]) {
                     std::cout << "Average time for PVS in 5 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
                     resultFile << "PVS," << threads << "," << averageTime << "\n";
                 }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: Jamboree\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 5; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.jamboree<White, maxDepth>(
+                                chessBoard,
+                                -50000,
+                                50000,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part Jamboree: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.jamboree<Black, maxDepth>(
+                                chessBoard,
+                                -50000,
+                                50000,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part Jamboree: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/5;
+                    std::cout << "Average time for Jamboree in 5 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "Jamboree," << threads << "," << averageTime << "\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: PVSplit\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 5; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.iterativePVSplit<White, maxDepth>(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part PVSplit: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.iterativePVSplit<Black, maxDepth>(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part PVSplit: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/5;
+                    std::cout << "Average time for PVSplit in 5 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "PVSplit," << threads << "," << averageTime << "\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: APHID\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 5; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            // Fresh master tree and table for every run
+                            APHID<maxDepth> aphid;
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = aphid.search(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part APHID: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            // Fresh master tree and table for every run
+                            APHID<maxDepth> aphid;
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = aphid.search(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part APHID: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/5;
+                    std::cout << "Average time for APHID in 5 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "APHID," << threads << "," << averageTime << "\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: MCTS\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    // One node pool for all runs, every search starts from an empty tree
+                    MCTS<maxDepth> mcts;
+                    for (int i = 0; i < 5; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = mcts.search(
+                                chessBoard,
+                                mctsPlayouts * depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part MCTS: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = mcts.search(
+                                chessBoard,
+                                mctsPlayouts * depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part MCTS: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/5;
+                    std::cout << "Average time for MCTS in 5 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "MCTS," << threads << "," << averageTime << "\n";
+                }
             }
 
         }
@@ -3,46 +3,160 @@
 #include <limits>
 #include <string>
 #include <cstdlib> // For std::atoi
+#include <atomic>
+#include <thread>
+#include <vector>
 #include "Backend/Board.h"
 #include "Backend/Type/Square.h"
 #include "SimplifiedMoveList.h"
 #include "Backend/Type/Color.h"
 #include "Engine.h"
+#include "Affinity.h"
+#include "APHID.h"
+#include "MCTS.h"
+#include "WorkFirstSearch.h"
+#include "MateSuites.h"
 #include <omp.h>
 #include <fstream> // For file I/O
 #include <iomanip> // For formatting output
 
 constexpr int maxDepth = 25;
+// MCTS playouts per ply of the requested depth
+constexpr int mctsPlayouts = 10000;
 
 // Function to convert a Square enum to its string representation (e.g., E2 -> "e2")
 std::string squareToString(Square square) {
     return std::string(1, File(square)) + std::string(1, Rank(square));
 }
 
+// Function to print the best move and the best line of a search result
+void printResult(const std::string &algorithm, const std::pair<std::array<Move, maxDepth>, int> &result, int depth) {
+    Move bestMove = result.first.front();
+    std::cout << "Best Move (" << algorithm << "): "
+              << squareToString(bestMove.From()) << " to "
+              << squareToString(bestMove.To())
+              << " with score " << result.second << "\n";
+
+    std::cout << "Best Line: ";
+    for (int i = 0; i < depth; i++) {
+        Move move = result.first[i];
+        std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+    }
+    std::cout << "\n";
+}
+
 // Function to display usage instructions
 void printUsage(const std::string &programName) {
-    std::cerr << "Usage: " << programName << " <depth>\n";
+    std::cerr << "Usage: " << programName << " <depth> [pin]\n";
     std::cerr << "  <depth> : Positive integer specifying the search depth.\n";
+    std::cerr << "  pin     : Pin search threads to physical cores first and SMT siblings last.\n";
+    std::cerr << "       " << programName << " check-deque\n";
+    std::cerr << "  check-deque : One owner pushes and pops while three thieves steal, checks each item is taken exactly once.\n";
     std::cerr << "Example:\n";
     std::cerr << "  " << programName << " 4\n";
 }
 
+// Function to set the number of search threads, and place them when pinning is on
+void setSearchThreads(int threads) {
+    omp_set_num_threads(threads);
+    if (Affinity::enabled()) {
+        Affinity::pinOpenMPThreads(threads);
+    }
+}
+
 // Function to display the algorithm options list
 void displayAlgorithmOptions() {
     std::cout << "Choose Search Algorithm:\n";
     std::cout << "1. Young Brothers Wait Concept (YBWC)\n";
     std::cout << "2. Principal Variation Search (PVS)\n";
     std::cout << "3. testing function\n";
-    std::cout << "Enter your choice (1,2, or 3): ";
+    std::cout << "4. Shared-memory Lazy SMP (one search process per core)\n";
+    std::cout << "5. APHID (asynchronous parallel hierarchical iterative deepening)\n";
+    std::cout << "6. MTD(f), sequential and with parallel zero window probes\n";
+    std::cout << "7. Monte Carlo Tree Search (tree parallel, virtual loss)\n";
+    std::cout << "8. Aspiration windows, sequential and speculative parallel\n";
+    std::cout << "9. Work-first search (continuations stolen, boards copied only on steal)\n";
+    std::cout << "Enter your choice (1-9): ";
+}
+
+// Function to stress the work-stealing deque: the owner pushes and pops at the bottom while three thieves steal from the
+// top. A small first buffer makes the deque grow while thieves are reading it. Every item has to be taken exactly once.
+int checkDeque() {
+    const int rounds = 20;
+    const int items = 100000;
+    const int thieves = 3;
+    bool ok = true;
+    for (int round = 0; round < rounds && ok; round++) {
+        WorkStealingDeque<int> deque(4);
+        std::vector<std::atomic<int>> taken(items);
+        std::atomic<bool> ownerDone{false};
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < thieves; i++) {
+            threads.emplace_back([&] {
+                int item;
+                // Nothing is pushed once the owner is done, so a failed steal after that means the deque stays empty
+                while (true) {
+                    bool done = ownerDone.load(std::memory_order_acquire);
+                    if (deque.steal(item)) {
+                        taken[item].fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else if (done) {
+                        break;
+                    }
+                }
+            });
+        }
+
+        int item;
+        for (int i = 0; i < items; i++) {
+            deque.push(i);
+            // Pop now and then, so the owner also races the thieves for the last item
+            if (i % 3 == 2 && deque.pop(item)) {
+                taken[item].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        while (!deque.empty()) {
+            if (deque.pop(item)) {
+                taken[item].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        ownerDone.store(true, std::memory_order_release);
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        for (int i = 0; i < items; i++) {
+            if (taken[i].load() != 1) {
+                std::cerr << "Round " << round << ": item " << i << " taken " << taken[i].load() << " times\n";
+                ok = false;
+                break;
+            }
+        }
+    }
+    std::cout << "Work-stealing deque: " << (ok ? "OK" : "FAILED") << "\n";
+    return ok ? 0 : 1;
 }
 
 int main(int argc, char* argv[]) {
+    if (argc == 2 && std::string(argv[1]) == "check-deque") {
+        return checkDeque();
+    }
+
     // Check if the depth argument is provided
-    if (argc != 2) {
+    if (argc != 2 && argc != 3) {
         std::cerr << "Error: Incorrect number of arguments.\n";
         printUsage(argv[0]);
         return 1;
     }
+    if (argc == 3) {
+        if (std::string(argv[2]) != "pin") {
+            std::cerr << "Unknown option: " << argv[2] << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+        Affinity::enable(true);
+    }
 
     // Parse the depth from the first command-line argument
     int depth = std::atoi(argv[1]);
@@ -68,10 +182,10 @@ int main(int argc, char* argv[]) {
             continue;
         }
 
-        if (algorithmChoice == 1 || algorithmChoice == 2 || algorithmChoice == 3) {
+        if (algorithmChoice >= 1 && algorithmChoice <= 9) {
             break; // Valid choice
         } else {
-            std::cerr << "Invalid choice: " << algorithmChoice << ". Please enter 1, 2 or 3.\n";
+            std::cerr << "Invalid choice: " << algorithmChoice << ". Please enter a number from 1 to 9.\n";
         }
     }
 
@@ -87,6 +201,24 @@ int main(int argc, char* argv[]) {
         case 3:
             algorithmName = "All algorithms";
             break;
+        case 4:
+            algorithmName = "Shared-memory Lazy SMP";
+            break;
+        case 5:
+            algorithmName = "APHID";
+            break;
+        case 6:
+            algorithmName = "MTD(f)";
+            break;
+        case 7:
+            algorithmName = "MCTS";
+            break;
+        case 8:
+            algorithmName = "Aspiration windows";
+            break;
+        case 9:
+            algorithmName = "Work-first search";
+            break;
         default:
             // This case should never occur due to the earlier validation
             algorithmName = "Unknown Algorithm";
@@ -236,18 +368,6 @@ int main(int argc, char* argv[]) {
         }
     }
     else if (algorithmChoice == 3) {
-        const char* mateIn3FENs[] = {
-            "7k/8/3NK3/5BN1/8/8/8/8 w - - 0 1",
-            "k7/3K4/3N4/2N5/8/3B4/8/8 w - - 0 1",
-            "8/8/2K5/7r/6r1/8/6k1/8 b - - 0 1",
-            "8/K7/7r/8/2k5/5bb1/8/8 b - - 0 1",
-            "8/K7/P6r/8/2k5/5bb1/8/8 b - - 0 1",
-            "8/8/8/8/k7/4Q3/3K4/8 w - - 0 1",
-            "8/8/k7/2K5/8/2Q5/b1R5/n7 w - - 0 1",
-            "8/8/k1K1b3/2n5/8/8/8/2R5 w - - 0 1",
-            "8/7P/k1K1b3/2n5/8/8/8/2R5 w - - 0 1",
-            "7k/7n/8/8/8/7B/7R/6RK w - - 0 1",
-        };
         std::ofstream resultFile("results.txt");
         if (!resultFile.is_open()) {
             std::cerr << "Error: Unable to open results.txt for writing\n";
@@ -364,8 +484,15 @@ int main(int argc, char* argv[]) {
 
                 int numThreads[] = {1, 2, 4, 8, 16, 32, 64};
 
+                //where each thread count runs, so the curves can be reproduced
                 for (int threads : numThreads) {
-                    omp_set_num_threads(threads);
+                    std::string placement = Affinity::enabled() ? Affinity::describe(threads) : "not pinned";
+                    std::cout << "Placement for " << threads << " threads: " << placement << "\n";
+                    resultFile << "Placement," << threads << ",\"" << placement << "\"\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
                     std::cout << "Algorithm: Parallel Minimax\n" << std::endl;
                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;
                     totalTime = 0;
@@ -497,7 +624,7 @@ int main(int argc, char* argv[]) {
                 resultFile << "Sequential AlphaBeta,1," << averageTime << "\n";
 
                 for (int threads : numThreads) {
-                    omp_set_num_threads(threads);
+                    setSearchThreads(threads);
                     std::cout << "Algorithm: Naive Alpha Beta Parallel\n" << std::endl;
 
                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;
@@ -568,7 +695,7 @@ int main(int argc, char* argv[]) {
                 }
 
                 for (int threads : numThreads) {
-                    omp_set_num_threads(threads);
+                    setSearchThreads(threads);
                     std::cout << "Algorithm: Naive Alpha Beta Parallel\n" << std::endl;
 
                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;
@@ -639,7 +766,7 @@ int main(int argc, char* argv[]) {
                 }
 
                 for (int threads : numThreads) {
-                    omp_set_num_threads(threads);
+                    setSearchThreads(threads);
                     std::cout << "Algorithm: YBWC\n" << std::endl;
 
                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;
@@ -710,15 +837,15 @@ int main(int argc, char* argv[]) {
                 }
 
                 for (int threads : numThreads) {
-                    omp_set_num_threads(threads);
-                    std::cout << "Algorithm: PVS\n" << std::endl;
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: Work Stealing YBWC\n" << std::endl;
 
                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;
                     totalTime = 0;
                     for (int i = 0; i < 20; i++) {
                         if (chessBoard.ColorToMove() == White) {
                             tstart = omp_get_wtime();
-                            std::pair<std::array<Move, maxDepth>, int> result = engine.PVS<White, maxDepth>(
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.stealingYBWC<White, maxDepth>(
                                 chessBoard,
                                 -50000,
                                 50000,
@@ -728,7 +855,7 @@ int main(int argc, char* argv[]) {
                             ttaken = tend - tstart;
                             totalTime += ttaken;
 
-                            printf("Time taken for main part PVS: %f\n", ttaken);
+                            printf("Time taken for main part work stealing YBWC: %f\n", ttaken);
 
                             if (!result.first.empty()) {
                                 Move bestMove = result.first.front();
@@ -747,7 +874,7 @@ int main(int argc, char* argv[]) {
                         }
                         else if (chessBoard.ColorToMove() == Black) {
                             tstart = omp_get_wtime();
-                            std::pair<std::array<Move, maxDepth>, int> result = engine.PVS<Black, maxDepth>(
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.stealingYBWC<Black, maxDepth>(
                                 chessBoard,
                                 -50000,
                                 50000,
@@ -757,7 +884,7 @@ int main(int argc, char* argv[]) {
                             ttaken = tend - tstart;
                             totalTime += ttaken;
 
-                            printf("Time taken for main part PVS: %f\n", ttaken);
+                            printf("Time taken for main part work stealing YBWC: %f\n", ttaken);
 
                             if (!result.first.empty()) {
                                 Move bestMove = result.first.front();
@@ -776,13 +903,690 @@ int main(int argc, char* argv[]) {
                         }
                     }
                     averageTime = totalTime/20;
-                    std::cout << "Average time for PVS in 20 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
-                    resultFile << "PVS," << threads << "," << averageTime << "\n";
+                    std::cout << "Average time for work stealing YBWC in 20 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "Work Stealing YBWC," << threads << "," << averageTime << "\n";
                 }
-            }
 
-        }
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: Team YBWC\n" << std::endl;
+                    ThreadTeam::shared().resetStats();
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 20; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.teamYBWC<White, maxDepth>(
+                                chessBoard,
+                                -50000,
+                                50000,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part team YBWC: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.teamYBWC<Black, maxDepth>(
+                                chessBoard,
+                                -50000,
+                                50000,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part team YBWC: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/20;
+                    std::cout << "Average time for team YBWC in 20 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "Team YBWC," << threads << "," << averageTime << "\n";
+                    //time the caller and the members spent waiting for work, and how awake they were when it came
+                    std::vector<ThreadTeam::Stats> teamStats = ThreadTeam::shared().stats();
+                    for (size_t member = 0; member < teamStats.size(); member++) {
+                        std::cout << (member == 0 ? "Team caller" : "Team member " + std::to_string(member)) << " idle " << teamStats[member].idleSeconds << "s, jobs " << teamStats[member].jobs
+                                  << " (woken spinning " << teamStats[member].spinWakeups << ", yielding " << teamStats[member].yieldWakeups
+                                  << ", sleeping " << teamStats[member].sleepWakeups << ")\n";
+                    }
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: Iterative Naive Alpha Beta Parallel\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 20; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.iterativeNaiveParallelAlphaBeta<White, maxDepth>(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part iterative naive alpha beta parallel: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.iterativeNaiveParallelAlphaBeta<Black, maxDepth>(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part iterative naive alpha beta parallel: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/20;
+                    std::cout << "Average time for iterative naive alpha beta parallel in 20 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "Iterative Naive Parallel Alpha Beta," << threads << "," << averageTime << "\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: Iterative YBWC\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 20; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.iterativeYBWC<White, maxDepth>(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part iterative YBWC: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.iterativeYBWC<Black, maxDepth>(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part iterative YBWC: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/20;
+                    std::cout << "Average time for iterative YBWC in 20 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "Iterative YBWC," << threads << "," << averageTime << "\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: PVS\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 20; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.PVS<White, maxDepth>(
+                                chessBoard,
+                                -50000,
+                                50000,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part PVS: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
 
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.PVS<Black, maxDepth>(
+                                chessBoard,
+                                -50000,
+                                50000,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part PVS: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/20;
+                    std::cout << "Average time for PVS in 20 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "PVS," << threads << "," << averageTime << "\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: Jamboree\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 20; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.jamboree<White, maxDepth>(
+                                chessBoard,
+                                -50000,
+                                50000,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part Jamboree: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.jamboree<Black, maxDepth>(
+                                chessBoard,
+                                -50000,
+                                50000,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part Jamboree: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/20;
+                    std::cout << "Average time for Jamboree in 20 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "Jamboree," << threads << "," << averageTime << "\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: PVSplit\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 20; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.iterativePVSplit<White, maxDepth>(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part PVSplit: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = engine.iterativePVSplit<Black, maxDepth>(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part PVSplit: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/20;
+                    std::cout << "Average time for PVSplit in 20 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "PVSplit," << threads << "," << averageTime << "\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: APHID\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    for (int i = 0; i < 20; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            // Fresh master tree and table for every run
+                            APHID<maxDepth> aphid;
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = aphid.search(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part APHID: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            // Fresh master tree and table for every run
+                            APHID<maxDepth> aphid;
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = aphid.search(
+                                chessBoard,
+                                depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part APHID: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/20;
+                    std::cout << "Average time for APHID in 20 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "APHID," << threads << "," << averageTime << "\n";
+                }
+
+                for (int threads : numThreads) {
+                    setSearchThreads(threads);
+                    std::cout << "Algorithm: MCTS\n" << std::endl;
+
+                    std::cout << "Total number of threads: " << threads << "\n" << std::endl;
+                    totalTime = 0;
+                    // One node pool for all runs, every search starts from an empty tree
+                    MCTS<maxDepth> mcts;
+                    for (int i = 0; i < 20; i++) {
+                        if (chessBoard.ColorToMove() == White) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = mcts.search(
+                                chessBoard,
+                                mctsPlayouts * depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part MCTS: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                        else if (chessBoard.ColorToMove() == Black) {
+                            tstart = omp_get_wtime();
+                            std::pair<std::array<Move, maxDepth>, int> result = mcts.search(
+                                chessBoard,
+                                mctsPlayouts * depth
+                            );
+                            tend = omp_get_wtime();
+                            ttaken = tend - tstart;
+                            totalTime += ttaken;
+
+                            printf("Time taken for main part MCTS: %f\n", ttaken);
+
+                            if (!result.first.empty()) {
+                                Move bestMove = result.first.front();
+                                std::cout << "White Result is: " << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                                          << " with score " << result.second << "\n";
+
+                                std::cout << "Best line: ";
+                                for (int i = 0; i < depth; i++) {
+                                    Move move = result.first[i];
+                                    std::cout << squareToString(move.From()) << " to " << squareToString(move.To()) << ", ";
+                                }
+                                std::cout << "\n";
+                            } else {
+                                std::cout << "No moves available for White.\n";
+                            }
+                        }
+                    }
+                    averageTime = totalTime/20;
+                    std::cout << "Average time for MCTS in 20 iterations is: " << averageTime << " with " << threads << " threads" << "\n";
+                    resultFile << "MCTS," << threads << "," << averageTime << "\n";
+                }
+            }
+
+        }
+
+    }
+    else if (algorithmChoice == 4) { // Lazy SMP over processes sharing one table
+#if defined(__unix__) || defined(__APPLE__)
+        int processes = omp_get_num_procs();
+        std::cout << "Search processes: " << processes << "\n";
+        tstart = omp_get_wtime();
+        if (currentPlayer == White) {
+            result = engine.sharedMemoryLazySMP<White, maxDepth>(chessBoard, depth, processes);
+        }
+        else {
+            result = engine.sharedMemoryLazySMP<Black, maxDepth>(chessBoard, depth, processes);
+        }
+        tend = omp_get_wtime();
+        ttaken = tend-tstart;
+        printf("Time taken for main part: %f\n", ttaken);
+        printResult("Shared-memory Lazy SMP", result, depth);
+#else
+        std::cerr << "Shared-memory Lazy SMP needs POSIX shared memory.\n";
+#endif
+    }
+    else if (algorithmChoice == 5) { // APHID, master tree over the first two plies
+        APHID<maxDepth> aphid;
+        std::cout << "Threads: " << omp_get_max_threads() << "\n";
+        tstart = omp_get_wtime();
+        result = aphid.search(chessBoard, depth, 2, [tstart](int finished, const std::pair<std::array<Move, maxDepth>, int> &current) {
+            Move bestMove = current.first.front();
+            std::cout << "Depth " << finished << " done after " << omp_get_wtime() - tstart << "s: "
+                      << squareToString(bestMove.From()) << " to " << squareToString(bestMove.To())
+                      << " with score " << current.second << "\n";
+        });
+        tend = omp_get_wtime();
+        ttaken = tend-tstart;
+        printf("Time taken for main part: %f\n", ttaken);
+        printResult("APHID", result, depth);
+    }
+    else if (algorithmChoice == 6) { // MTD(f) on one table, emptied before each run
+        NumaTranspositionTable<SearchEntry> transpositionTable(16 * 1024 * 1024);
+        //one interleaved table or one that sits on a single node changes what the timings measure
+        std::cout << "Transposition table: " << (transpositionTable.NumaInterleaved() ? "interleaved over all NUMA nodes" : "on one node") << "\n";
+        tstart = omp_get_wtime();
+        if (currentPlayer == White) {
+            result = engine.iterativeMTDF<White, maxDepth>(transpositionTable, chessBoard, depth);
+        }
+        else {
+            result = engine.iterativeMTDF<Black, maxDepth>(transpositionTable, chessBoard, depth);
+        }
+        tend = omp_get_wtime();
+        ttaken = tend-tstart;
+        printf("Time taken for main part MTD(f): %f\n", ttaken);
+        printResult("MTD(f)", result, depth);
+
+        transpositionTable.Clear();
+        std::cout << "Parallel probes: " << omp_get_max_threads() << "\n";
+        tstart = omp_get_wtime();
+        if (currentPlayer == White) {
+            result = engine.iterativeParallelMTDF<White, maxDepth>(transpositionTable, chessBoard, depth);
+        }
+        else {
+            result = engine.iterativeParallelMTDF<Black, maxDepth>(transpositionTable, chessBoard, depth);
+        }
+        tend = omp_get_wtime();
+        ttaken = tend-tstart;
+        printf("Time taken for main part parallel MTD(f): %f\n", ttaken);
+        printResult("Parallel MTD(f)", result, depth);
+    }
+    else if (algorithmChoice == 7) { // MCTS, the playout budget grows with the depth
+        MCTS<maxDepth> mcts;
+        std::cout << "Playouts: " << mctsPlayouts * depth << ", threads: " << omp_get_max_threads() << "\n";
+        tstart = omp_get_wtime();
+        result = mcts.search(chessBoard, mctsPlayouts * depth);
+        tend = omp_get_wtime();
+        ttaken = tend-tstart;
+        printf("Time taken for main part: %f\n", ttaken);
+        std::cout << "Tree nodes: " << mcts.size() << "\n";
+        printResult("MCTS", result, depth);
+    }
+    else if (algorithmChoice == 8) { // aspiration windows on one table, emptied before each run
+        NumaTranspositionTable<SearchEntry> transpositionTable(16 * 1024 * 1024);
+        std::cout << "Transposition table: " << (transpositionTable.NumaInterleaved() ? "interleaved over all NUMA nodes" : "on one node") << "\n";
+        tstart = omp_get_wtime();
+        if (currentPlayer == White) {
+            result = engine.iterativeAspiration<White, maxDepth>(transpositionTable, chessBoard, depth);
+        }
+        else {
+            result = engine.iterativeAspiration<Black, maxDepth>(transpositionTable, chessBoard, depth);
+        }
+        tend = omp_get_wtime();
+        ttaken = tend-tstart;
+        printf("Time taken for main part aspiration windows: %f\n", ttaken);
+        printResult("Aspiration windows", result, depth);
+
+        transpositionTable.Clear();
+        std::cout << "Speculative windows: " << omp_get_max_threads() << "\n";
+        tstart = omp_get_wtime();
+        if (currentPlayer == White) {
+            result = engine.iterativeParallelAspiration<White, maxDepth>(transpositionTable, chessBoard, depth);
+        }
+        else {
+            result = engine.iterativeParallelAspiration<Black, maxDepth>(transpositionTable, chessBoard, depth);
+        }
+        tend = omp_get_wtime();
+        ttaken = tend-tstart;
+        printf("Time taken for main part parallel aspiration windows: %f\n", ttaken);
+        printResult("Parallel aspiration windows", result, depth);
+    }
+    else if (algorithmChoice == 9) { // work-first search, the steals are the only board copies
+        WorkFirstSearch<maxDepth> workFirst;
+        std::cout << "Threads: " << omp_get_max_threads() << "\n";
+        tstart = omp_get_wtime();
+        result = workFirst.search(chessBoard, depth);
+        tend = omp_get_wtime();
+        ttaken = tend-tstart;
+        printf("Time taken for main part: %f\n", ttaken);
+        std::cout << "Continuations stolen: " << workFirst.stealCount() << "\n";
+        printResult("Work-first search", result, depth);
     }
 
     return 0;
@@ -917,7 +1721,7 @@ int main(int argc, char* argv[]) {
 //                 int numThreads[] = {1, 2, 4, 8, 16, 32, 64};
 //
 //                 for (int threads : numThreads) {
-//                     omp_set_num_threads(threads);
+//                     setSearchThreads(threads);
 //                     std::cout << "Algorithm: Parallel Minimax\n" << std::endl;
 //                     std::cout << "Total number of threads: " << numThreads << "\n" << std::endl;
 //                     totalTime = 0;
@@ -1047,7 +1851,7 @@ int main(int argc, char* argv[]) {
 //                 std::cout << "Average time for sequential AlphaBeta in 20 iterations is: " << averageTime << " with " << numThreads << "\n";
 //
 //                 for (int threads : numThreads) {
-//                     omp_set_num_threads(threads);
+//                     setSearchThreads(threads);
 //                     std::cout << "Algorithm: Naive Alpha Beta Parallel\n" << std::endl;
 //
 //                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;
@@ -1117,7 +1921,7 @@ int main(int argc, char* argv[]) {
 //                 }
 //
 //                 for (int threads : numThreads) {
-//                     omp_set_num_threads(threads);
+//                     setSearchThreads(threads);
 //                     std::cout << "Algorithm: YBWC\n" << std::endl;
 //
 //                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;
@@ -1187,7 +1991,7 @@ int main(int argc, char* argv[]) {
 //                 }
 //
 //                 for (int threads : numThreads) {
-//                     omp_set_num_threads(threads);
+//                     setSearchThreads(threads);
 //                     std::cout << "Algorithm: PVS\n" << std::endl;
 //
 //                     std::cout << "Total number of threads: " << threads << "\n" << std::endl;